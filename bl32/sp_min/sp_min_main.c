@@ -33,6 +33,8 @@
 #if ENABLE_RUNTIME_INSTRUMENTATION
 PMF_REGISTER_SERVICE_SMC(rt_instr_svc, PMF_RT_INSTR_SVC_ID,
 	RT_INSTR_TOTAL_IDS, PMF_STORE_ENABLE)
+PMF_REGISTER_TRACE_SERVICE_SMC(rt_trace_svc, PMF_RT_TRACE_SVC_ID,
+	RT_INSTR_TOTAL_IDS)
 #endif
 
 /* Pointers to per-core cpu contexts */
@@ -47,6 +47,17 @@ static int dyn_is_auth_disabled(void)
 }
 #endif /* TRUSTED_BOARD_BOOT */
 
+/*
+ * Size of the chunks in which an image is read when its hash is calculated
+ * while it is being loaded. Each chunk is hashed right after landing in memory,
+ * while it is still in the data cache.
+ */
+#define LOAD_IMAGE_CHUNK_SIZE	U(0x8000)
+
+/* Consumer registered for the data of the next image loaded in image_data */
+static image_info_t *stream_image_data;
+static image_stream_t *image_stream;
+
 uintptr_t page_align(uintptr_t value, unsigned dir)
 {
 	/* Round up the limit to the next page boundary */
@@ -59,15 +70,122 @@ uintptr_t page_align(uintptr_t value, unsigned dir)
 	return value;
 }
 
+#if TRUSTED_BOARD_BOOT
+/*******************************************************************************
+ * Internal function to read an image in chunks, passing each of them to the
+ * authentication module to hash it as the data arrives.
+ *
+ * Returns 0 on success, a negative error code otherwise.
+ ******************************************************************************/
+static int read_and_hash_image(uintptr_t image_handle, uintptr_t image_base,
+			       size_t image_size, size_t *bytes_read)
+{
+	size_t chunk_size;
+	size_t chunk_read;
+	int io_result = 0;
+
+	*bytes_read = 0U;
+
+	while (*bytes_read < image_size) {
+		chunk_size = MIN(image_size - *bytes_read,
+				 (size_t)LOAD_IMAGE_CHUNK_SIZE);
+
+		io_result = io_read(image_handle, image_base + *bytes_read,
+				    chunk_size, &chunk_read);
+		if ((io_result != 0) || (chunk_read == 0U)) {
+			break;
+		}
+
+		auth_mod_hash_stream_update((void *)(image_base + *bytes_read),
+					    (unsigned int)chunk_read);
+		*bytes_read += chunk_read;
+	}
+
+	auth_mod_hash_stream_end();
+
+	return io_result;
+}
+#endif /* TRUSTED_BOARD_BOOT */
+
+/*******************************************************************************
+ * Internal function to read an image in chunks into the buffer of a stream and
+ * hand them over to it. If 'hashing' is set, the chunks are also passed to the
+ * authentication module to hash the image on the way.
+ *
+ * Returns 0 on success, a negative error code otherwise.
+ ******************************************************************************/
+static int read_and_stream_image(uintptr_t image_handle, image_stream_t *stream,
+				 size_t image_size, bool hashing,
+				 size_t *bytes_read)
+{
+	size_t chunk_size;
+	size_t chunk_read;
+	int io_result = 0;
+	int rc;
+
+	*bytes_read = 0U;
+
+	while (*bytes_read < image_size) {
+		chunk_size = MIN(image_size - *bytes_read, stream->buf_size);
+
+		io_result = io_read(image_handle, stream->buf, chunk_size,
+				    &chunk_read);
+		if ((io_result != 0) || (chunk_read == 0U)) {
+			break;
+		}
+
+#if TRUSTED_BOARD_BOOT
+		if (hashing) {
+			auth_mod_hash_stream_update((void *)stream->buf,
+						    (unsigned int)chunk_read);
+		}
+#endif
+		*bytes_read += chunk_read;
+
+		io_result = stream->update(stream->buf, chunk_read);
+		if (io_result != 0) {
+			break;
+		}
+	}
+
+#if TRUSTED_BOARD_BOOT
+	if (hashing) {
+		auth_mod_hash_stream_end();
+	}
+#endif
+
+	rc = stream->end();
+
+	return (io_result != 0) ? io_result : rc;
+}
+
+/*******************************************************************************
+ * Register a consumer for the data of the next image loaded in 'image_data' by
+ * load_auth_image(). The registration is dropped once that image is loaded.
+ ******************************************************************************/
+void set_image_stream(image_info_t *image_data, image_stream_t *stream)
+{
+	stream_image_data = image_data;
+	image_stream = stream;
+	if (stream != NULL) {
+		stream->streamed = false;
+	}
+}
+
 /*******************************************************************************
  * Internal function to load an image at a specific address given
  * an image ID and extents of free memory.
  *
- * If the load is successful then the image information is updated.
+ * If the load is successful then the image information is updated. If
+ * 'hash_on_load' is set, the image is hashed while it is read so that its
+ * authentication does not need another pass over it. If 'allow_stream' is set
+ * and a stream is registered for 'image_data', the image may be handed to it
+ * instead of being loaded in memory.
  *
  * Returns 0 on success, a negative error code otherwise.
  ******************************************************************************/
-static int load_image(unsigned int image_id, image_info_t *image_data)
+static int load_image(unsigned int image_id, image_info_t *image_data,
+		      bool hash_on_load, bool allow_stream)
 {
 	uintptr_t dev_handle;
 	uintptr_t image_handle;
@@ -75,13 +193,13 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 	uintptr_t image_base;
 	size_t image_size;
 	size_t bytes_read;
+	image_stream_t *stream = NULL;
+	bool hashing = false;
 	int io_result;
 
 	assert(image_data != NULL);
 	assert(image_data->h.version >= VERSION_2);
 
-	image_base = image_data->image_base;
-
 	/* Obtain a reference to the image by querying the platform layer */
 	io_result = plat_get_image_source(image_id, &dev_handle, &image_spec);
 	if (io_result != 0) {
@@ -98,6 +216,8 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 		return io_result;
 	}
 
+	image_base = image_data->image_base;
+
 	INFO("Loading image id=%u at address 0x%lx\n", image_id, image_base);
 
 	/* Find the size of the image */
@@ -121,18 +241,81 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 	 */
 	image_data->image_size = (uint32_t)image_size;
 
+#if TRUSTED_BOARD_BOOT
+	/*
+	 * Encrypted images can only be read in one go, as they are decrypted
+	 * and authenticated as a whole by the IO layer.
+	 */
+	if (hash_on_load && (io_dev_type(dev_handle) != IO_TYPE_ENCRYPTED)) {
+		hashing = (auth_mod_hash_stream_start(image_id) == 0);
+	}
+#endif
+
+	/*
+	 * A streamed image is never whole in memory, so it must be hashed on
+	 * the way if it is authenticated, and it cannot be measured.
+	 */
+	if (allow_stream && (image_stream != NULL) &&
+	    (image_data == stream_image_data) &&
+	    (hashing || !hash_on_load) && (MEASURED_BOOT == 0)) {
+		stream = image_stream;
+		stream->streamed = false;
+		io_result = stream->start(image_data);
+		if (io_result != 0) {
+			WARN("Failed to start streaming image id=%u (%i)\n",
+			     image_id, io_result);
+			stream = NULL;
+#if TRUSTED_BOARD_BOOT
+			if (hashing) {
+				auth_mod_hash_stream_end();
+			}
+#endif
+			goto exit;
+		}
+
+		/* The stream may have moved the image */
+		image_base = image_data->image_base;
+	}
+
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+	if (stream != NULL) {
+		io_result = read_and_stream_image(image_handle, stream,
+						  image_size, hashing,
+						  &bytes_read);
+	}
+#if TRUSTED_BOARD_BOOT
+	else if (hashing) {
+		io_result = read_and_hash_image(image_handle, image_base,
+						image_size, &bytes_read);
+	}
+#endif
+	else {
+		io_result = io_read(image_handle, image_base, image_size,
+				    &bytes_read);
+	}
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
+		if (io_result == 0) {
+			io_result = -EIO;
+		}
 		goto exit;
 	}
 
-	INFO("Image id=%u loaded: 0x%lx - 0x%lx\n", image_id, image_base,
-	     (uintptr_t)(image_base + image_size));
+	if (stream != NULL) {
+		stream->streamed = true;
+		INFO("Image id=%u streamed: 0x%zx bytes\n", image_id,
+		     image_size);
+	} else {
+		INFO("Image id=%u loaded: 0x%lx - 0x%lx\n", image_id,
+		     image_base, (uintptr_t)(image_base + image_size));
+	}
 
 exit:
+	if ((io_result != 0) && (stream != NULL)) {
+		stream->discard(image_data);
+	}
+
 	(void)io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
@@ -164,8 +347,8 @@ static int load_auth_image_recursive(unsigned int image_id,
 		}
 	}
 
-	/* Load the image */
-	rc = load_image(image_id, image_data);
+	/* Load the image, hashing it on the way if possible */
+	rc = load_image(image_id, image_data, true, is_parent_image == 0);
 	if (rc != 0) {
 		return rc;
 	}
@@ -180,6 +363,11 @@ static int load_auth_image_recursive(unsigned int image_id,
 			       image_data->image_size);
 		flush_dcache_range(image_data->image_base,
 				   image_data->image_size);
+		if ((is_parent_image == 0) && (image_data == stream_image_data) &&
+		    image_stream->streamed) {
+			image_stream->streamed = false;
+			image_stream->discard(image_data);
+		}
 		return -EAUTH;
 	}
 
@@ -196,7 +384,7 @@ static int load_auth_image_internal(unsigned int image_id,
 	}
 #endif
 
-	return load_image(image_id, image_data);
+	return load_image(image_id, image_data, false, true);
 }
 
 /*******************************************************************************
@@ -227,6 +415,10 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 
 #endif /* PSA_FWU_SUPPORT */
 
+	if (image_data == stream_image_data) {
+		set_image_stream(NULL, NULL);
+	}
+
 	if (err == 0) {
 		/*
 		 * If loading of the image gets passed (along with its
@@ -234,6 +426,13 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 		 * it (if MEASURED_BOOT flag is enabled).
 		 */
 		err = plat_mboot_measure_image(image_id, image_data);
+
+		/*
+		 * The digest computed to authenticate the image, if any, can
+		 * only be reused to measure it until it is handed over.
+		 */
+		auth_mod_discard_img_hash();
+
 		if (err != 0) {
 			return err;
 		}
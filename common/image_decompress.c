@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -11,11 +11,24 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/image_decompress.h>
+#include <lib/utils.h>
+
+/*
+ * Size of the chunks the compressed data is read in when it is streamed to the
+ * decompressor. They are read at the start of the temporary buffer, the rest
+ * of it being the workspace of the decompressor.
+ */
+#define IMAGE_DECOMPRESS_CHUNK_SIZE	U(0x8000)
 
 static uintptr_t decompressor_buf_base;
 static uint32_t decompressor_buf_size;
 static decompressor_t *decompressor;
 static struct image_info saved_image_info;
+#if IMAGE_DECOMPRESS_STREAM
+static const decompressor_stream_t *stream_decompressor;
+static image_stream_t image_stream;
+static uintptr_t stream_out_end;
+#endif
 
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *_decompressor)
@@ -25,6 +38,58 @@ void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 	decompressor = _decompressor;
 }
 
+#if IMAGE_DECOMPRESS_STREAM
+/*
+ * Decompress images while they are read, straight to their destination,
+ * whenever the loader allows it. The compressed image is then never stored
+ * in the temporary buffer, but it is decompressed before being authenticated.
+ */
+void image_decompress_stream_init(const decompressor_stream_t *stream)
+{
+	assert(decompressor_buf_size > IMAGE_DECOMPRESS_CHUNK_SIZE);
+
+	stream_decompressor = stream;
+}
+
+static int image_decompress_stream_start(struct image_info *info)
+{
+	uintptr_t work_base = decompressor_buf_base +
+			      IMAGE_DECOMPRESS_CHUNK_SIZE;
+	size_t work_size = decompressor_buf_size -
+			   IMAGE_DECOMPRESS_CHUNK_SIZE;
+
+	/* The output goes straight to the final destination */
+	info->image_base = saved_image_info.image_base;
+	info->image_max_size = saved_image_info.image_max_size;
+
+	return stream_decompressor->start(info->image_base,
+					  info->image_max_size,
+					  work_base, work_size);
+}
+
+static int image_decompress_stream_update(uintptr_t chunk, size_t len)
+{
+	return stream_decompressor->update(chunk, len);
+}
+
+static int image_decompress_stream_end(void)
+{
+	return stream_decompressor->end(&stream_out_end);
+}
+
+static void image_decompress_stream_discard(struct image_info *info)
+{
+	/* Erase whatever was decompressed, it cannot be trusted */
+	zero_normalmem((void *)saved_image_info.image_base,
+		       saved_image_info.image_max_size);
+	flush_dcache_range(saved_image_info.image_base,
+			   saved_image_info.image_max_size);
+
+	info->image_base = decompressor_buf_base;
+	info->image_max_size = decompressor_buf_size;
+}
+#endif /* IMAGE_DECOMPRESS_STREAM */
+
 void image_decompress_prepare(struct image_info *info)
 {
 	/*
@@ -36,6 +101,22 @@ void image_decompress_prepare(struct image_info *info)
 	saved_image_info = *info;
 	info->image_base = decompressor_buf_base;
 	info->image_max_size = decompressor_buf_size;
+
+#if IMAGE_DECOMPRESS_STREAM
+	/*
+	 * Offer the loader to stream the compressed data to the decompressor
+	 * instead, in which case it lands nowhere but in the chunk buffer.
+	 */
+	if (stream_decompressor != NULL) {
+		image_stream.buf = decompressor_buf_base;
+		image_stream.buf_size = IMAGE_DECOMPRESS_CHUNK_SIZE;
+		image_stream.start = image_decompress_stream_start;
+		image_stream.update = image_decompress_stream_update;
+		image_stream.end = image_decompress_stream_end;
+		image_stream.discard = image_decompress_stream_discard;
+		set_image_stream(info, &image_stream);
+	}
+#endif
 }
 
 int image_decompress(struct image_info *info)
@@ -44,6 +125,19 @@ int image_decompress(struct image_info *info)
 	uint32_t compressed_image_size, work_size;
 	int ret;
 
+#if IMAGE_DECOMPRESS_STREAM
+	/* A streamed image was decompressed while it was loaded */
+	if (image_stream.streamed) {
+		image_stream.streamed = false;
+		*info = saved_image_info;
+		info->image_size = stream_out_end - info->image_base;
+
+		flush_dcache_range(info->image_base, info->image_size);
+
+		return 0;
+	}
+#endif
+
 	/*
 	 * The size of compressed data has been filled by load_image().
 	 * Read it out before restoring image_info.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -25,6 +25,25 @@ uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 #define RT_SVC_DECS_NUM		((RT_SVC_DESCS_END - RT_SVC_DESCS_START)\
 					/ sizeof(rt_svc_desc_t))
 
+#if RT_SVC_FAST_PATH
+/*******************************************************************************
+ * The 'rt_svc_fast_descs' array holds a copy of the fast SMC handler
+ * descriptors exported by services in the 'rt_svc_fast_descs' linker section,
+ * grouped by unique owning entity number. Each group ends with a descriptor
+ * whose function id is 0, which is not a valid fast SMC function id. The
+ * 'rt_svc_fast_descs_indices' array holds the index of the group of each
+ * unique owning entity number in the 'rt_svc_fast_descs' array. When an SMC
+ * arrives, only the fast handlers of its owning entity are compared with its
+ * function id.
+ ******************************************************************************/
+uint8_t rt_svc_fast_descs_indices[MAX_RT_SVCS];
+rt_svc_fast_desc_t rt_svc_fast_descs[MAX_RT_SVC_FAST_DESCS];
+
+#define RT_SVC_FAST_DECS_NUM	((RT_SVC_FAST_DESCS_END - \
+					RT_SVC_FAST_DESCS_START) \
+					/ sizeof(rt_svc_fast_desc_t))
+#endif
+
 /*******************************************************************************
  * Function to invoke the registered `handle` corresponding to the smc_fid in
  * AArch32 mode.
@@ -80,6 +99,77 @@ static int32_t validate_rt_svc_desc(const rt_svc_desc_t *desc)
 	return 0;
 }
 
+#if RT_SVC_FAST_PATH
+/*******************************************************************************
+ * Simple routine to sanity check a fast SMC handler descriptor before using it
+ ******************************************************************************/
+static int32_t validate_rt_svc_fast_desc(const rt_svc_fast_desc_t *desc)
+{
+	if (desc->handle == NULL)
+		return -EINVAL;
+
+	if (GET_SMC_TYPE(desc->smc_fid) != SMC_TYPE_FAST)
+		return -EINVAL;
+
+	if ((desc->smc_fid & (FUNCID_SVE_HINT_MASK << FUNCID_SVE_HINT_SHIFT))
+	    != 0U)
+		return -EINVAL;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * This function fills the 'rt_svc_fast_descs' and 'rt_svc_fast_descs_indices'
+ * arrays from the fast SMC handler descriptors. The fast handlers of an owning
+ * entity whose runtime service failed to initialise are not used.
+ ******************************************************************************/
+static void __init runtime_svc_fast_init(void)
+{
+	const rt_svc_fast_desc_t *fast_descs;
+	unsigned int oen, index, start, count = 0U;
+
+	/* Initialise internal variables to invalid state */
+	(void)memset(rt_svc_fast_descs_indices, -1,
+		     sizeof(rt_svc_fast_descs_indices));
+
+	fast_descs = (const rt_svc_fast_desc_t *) RT_SVC_FAST_DESCS_START;
+	for (index = 0U; index < RT_SVC_FAST_DECS_NUM; index++) {
+		if (validate_rt_svc_fast_desc(&fast_descs[index]) != 0) {
+			ERROR("Invalid fast SMC handler descriptor %p\n",
+				(const void *) &fast_descs[index]);
+			panic();
+		}
+	}
+
+	for (oen = 0U; oen < MAX_RT_SVCS; oen++) {
+		if (rt_svc_descs_indices[oen] >= RT_SVC_DECS_NUM)
+			continue;
+
+		start = count;
+		for (index = 0U; index < RT_SVC_FAST_DECS_NUM; index++) {
+			if (get_unique_oen_from_smc_fid(
+				fast_descs[index].smc_fid) != oen)
+				continue;
+
+			/* Keep room for the terminator of the group */
+			if (count >= (MAX_RT_SVC_FAST_DESCS - 1U)) {
+				ERROR("Too many fast SMC handlers\n");
+				panic();
+			}
+			rt_svc_fast_descs[count] = fast_descs[index];
+			count++;
+		}
+
+		if (count != start) {
+			rt_svc_fast_descs[count].smc_fid = 0U;
+			rt_svc_fast_descs[count].handle = NULL;
+			count++;
+			rt_svc_fast_descs_indices[oen] = (uint8_t)start;
+		}
+	}
+}
+#endif /* RT_SVC_FAST_PATH */
+
 /*******************************************************************************
  * This function calls the initialisation routine in the descriptor exported by
  * a runtime service. Once a descriptor has been validated, its start & end
@@ -151,4 +241,8 @@ void __init runtime_svc_init(void)
 		for (; start_idx <= end_idx; start_idx++)
 			rt_svc_descs_indices[start_idx] = index;
 	}
+
+#if RT_SVC_FAST_PATH
+	runtime_svc_fast_init();
+#endif
 }
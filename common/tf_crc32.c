@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,16 +7,150 @@
 #include <stdarg.h>
 #include <assert.h>
 
+#if __ARM_FEATURE_CRC32
 #include <arm_acle.h>
+#endif
 #include <common/debug.h>
 #include <common/tf_crc32.h>
 
+/* Reversed CRC-32 (IEEE 802.3) polynomial */
+#define CRC32_POLY_REV		0xedb88320U
+
+/*
+ * Size of each of the independent streams a large buffer is split into. The
+ * CRC instructions have a latency of several cycles but can be issued every
+ * cycle, so interleaving three streams keeps the pipeline busy. Streams are
+ * large enough for the cost of merging them to be negligible.
+ */
+#define CRC32_LANE_SIZE		1024U
+#define CRC32_LANES		3U
+
+/*
+ * x^(8 * CRC32_LANE_SIZE) and x^(16 * CRC32_LANE_SIZE) modulo the CRC-32
+ * polynomial, in reversed bit order. Multiplying a CRC register by these
+ * advances it over one or two lanes of zero bytes.
+ */
+#define CRC32_X_LANE		0x6427800eU
+#define CRC32_X_2LANES		0x4d47bae0U
+
+#if __ARM_FEATURE_CRC32
+/*
+ * Wrappers around the CRC instructions, fed with little-endian loads so that
+ * the bytes are consumed in memory order.
+ */
+static inline uint32_t crc32_u8(uint32_t crc, const unsigned char *p)
+{
+	return __crc32b(crc, *p);
+}
+
+static inline uint32_t crc32_u16(uint32_t crc, const unsigned char *p)
+{
+	return __crc32h(crc, *(const uint16_t *)p);
+}
+
+static inline uint32_t crc32_u32(uint32_t crc, const unsigned char *p)
+{
+	return __crc32w(crc, *(const uint32_t *)p);
+}
+
+static inline uint32_t crc32_u64(uint32_t crc, const unsigned char *p)
+{
+	return __crc32d(crc, *(const uint64_t *)p);
+}
+#else
+/*
+ * Bitwise fallback for CPUs without the CRC instructions. Slow, but it does
+ * not need a lookup table.
+ */
+static uint32_t crc32_bits(uint32_t crc, uint64_t data, unsigned int bits)
+{
+	unsigned int i;
+
+	crc ^= (uint32_t)data;
+	data >>= 32;
+
+	for (i = 0U; i < bits; i++) {
+		if (i == 32U) {
+			crc ^= (uint32_t)data;
+		}
+		crc = (crc >> 1) ^ (CRC32_POLY_REV & (0U - (crc & 1U)));
+	}
+
+	return crc;
+}
+
+static inline uint32_t crc32_u8(uint32_t crc, const unsigned char *p)
+{
+	return crc32_bits(crc, *p, 8U);
+}
+
+static inline uint32_t crc32_u16(uint32_t crc, const unsigned char *p)
+{
+	return crc32_bits(crc, *(const uint16_t *)p, 16U);
+}
+
+static inline uint32_t crc32_u32(uint32_t crc, const unsigned char *p)
+{
+	return crc32_bits(crc, *(const uint32_t *)p, 32U);
+}
+
+static inline uint32_t crc32_u64(uint32_t crc, const unsigned char *p)
+{
+	return crc32_bits(crc, *(const uint64_t *)p, 64U);
+}
+#endif /* __ARM_FEATURE_CRC32 */
+
+/*
+ * Multiply two polynomials modulo the CRC-32 polynomial, both in reversed bit
+ * order. This is used to merge the CRCs of independent streams, as the CRC
+ * register after a buffer B is (crc_in * x^(8 * len(B))) ^ CRC(0, B).
+ */
+static uint32_t crc32_multmod(uint32_t a, uint32_t b)
+{
+	uint32_t prod = 0U;
+	unsigned int i;
+
+	for (i = 0U; i < 32U; i++) {
+		prod ^= b & (0U - (a >> 31));
+		a <<= 1;
+		b = (b >> 1) ^ (CRC32_POLY_REV & (0U - (b & 1U)));
+	}
+
+	return prod;
+}
+
+/*
+ * Calculate the CRC of CRC32_LANES consecutive lanes of CRC32_LANE_SIZE
+ * bytes, running one independent CRC per lane and merging them at the end.
+ */
+static uint32_t crc32_lanes(uint32_t crc, const unsigned char *buf)
+{
+	const unsigned char *end = buf + CRC32_LANE_SIZE;
+	uint32_t crc1 = 0U;
+	uint32_t crc2 = 0U;
+
+	while (buf < end) {
+		crc = crc32_u64(crc, buf);
+		crc1 = crc32_u64(crc1, buf + CRC32_LANE_SIZE);
+		crc2 = crc32_u64(crc2, buf + (2U * CRC32_LANE_SIZE));
+		buf += sizeof(uint64_t);
+	}
+
+	return crc32_multmod(crc, CRC32_X_2LANES) ^
+	       crc32_multmod(crc1, CRC32_X_LANE) ^ crc2;
+}
+
 /* compute CRC using Arm intrinsic function
  *
  * This function is useful for the platforms with the CPU ARMv8.0
  * (with CRC instructions supported), and onwards.
  * Platforms with CPU ARMv8.0 should make sure to add a compile switch
- * '-march=armv8-a+crc" for successful compilation of this file.
+ * '-march=armv8-a+crc" for successful compilation of this file. Without it,
+ * a much slower bitwise implementation is used.
+ *
+ * The buffer is consumed with byte and halfword accesses up to the first
+ * doubleword boundary, then a doubleword at a time, spread over several
+ * independent streams for large buffers.
  *
  * @crc: previous accumulated CRC
  * @buf: buffer base address
@@ -33,13 +167,56 @@ uint32_t tf_crc32(uint32_t crc, const unsigned char *buf, size_t size)
 	size_t local_size = size;
 
 	/*
-	 * calculate CRC over byte data
+	 * calculate CRC over the unaligned head
 	 */
-	while (local_size != 0UL) {
-		calc_crc = __crc32b(calc_crc, *local_buf);
+	if ((((uintptr_t)local_buf & 1U) != 0U) && (local_size >= 1U)) {
+		calc_crc = crc32_u8(calc_crc, local_buf);
 		local_buf++;
 		local_size--;
 	}
+	if ((((uintptr_t)local_buf & 2U) != 0U) && (local_size >= 2U)) {
+		calc_crc = crc32_u16(calc_crc, local_buf);
+		local_buf += 2;
+		local_size -= 2U;
+	}
+	if ((((uintptr_t)local_buf & 4U) != 0U) && (local_size >= 4U)) {
+		calc_crc = crc32_u32(calc_crc, local_buf);
+		local_buf += 4;
+		local_size -= 4U;
+	}
+
+	/*
+	 * calculate CRC over doubleword data, interleaving independent
+	 * streams while the buffer is large enough
+	 */
+	while (local_size >= (CRC32_LANES * CRC32_LANE_SIZE)) {
+		calc_crc = crc32_lanes(calc_crc, local_buf);
+		local_buf += CRC32_LANES * CRC32_LANE_SIZE;
+		local_size -= CRC32_LANES * CRC32_LANE_SIZE;
+	}
+
+	while (local_size >= 8U) {
+		calc_crc = crc32_u64(calc_crc, local_buf);
+		local_buf += 8;
+		local_size -= 8U;
+	}
+
+	/*
+	 * calculate CRC over the remaining tail
+	 */
+	if (local_size >= 4U) {
+		calc_crc = crc32_u32(calc_crc, local_buf);
+		local_buf += 4;
+		local_size -= 4U;
+	}
+	if (local_size >= 2U) {
+		calc_crc = crc32_u16(calc_crc, local_buf);
+		local_buf += 2;
+		local_size -= 2U;
+	}
+	if (local_size != 0U) {
+		calc_crc = crc32_u8(calc_crc, local_buf);
+	}
 
 	return ~calc_crc;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -23,6 +23,23 @@
 #endif
 
 
+/*
+ * Private helper function to wait for the SCP to hand the channel back to the
+ * AP, i.e. for it to have consumed the last command and written its response.
+ */
+static void scmi_wait_channel_free(const mailbox_mem_t *mbx_mem)
+{
+	while (!SCMI_IS_CHANNEL_FREE(mbx_mem->status))
+		;
+
+	/*
+	 * Ensure that any read to the SCMI payload area is done after reading
+	 * mailbox status. If these 2 reads were reordered then the CPU would
+	 * read invalid payload data
+	 */
+	dmbld();
+}
+
 /*
  * Private helper function to get exclusive access to SCMI channel.
  */
@@ -31,15 +48,17 @@ void scmi_get_channel(scmi_channel_t *ch)
 	assert(ch->lock);
 	scmi_lock_get(ch->lock);
 
-	/* Make sure any previous command has finished */
-	assert(SCMI_IS_CHANNEL_FREE(
-			((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->status));
+	/*
+	 * A command sent with scmi_send_async_command() may still be in
+	 * flight. Make sure it has finished before reusing the mailbox.
+	 */
+	scmi_wait_channel_free((mailbox_mem_t *)(ch->info->scmi_mbx_mem));
 }
 
 /*
  * Private helper function to transfer ownership of channel from AP to SCP.
  */
-void scmi_send_sync_command(scmi_channel_t *ch)
+static void scmi_post_command(scmi_channel_t *ch)
 {
 	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
 
@@ -53,6 +72,16 @@ void scmi_send_sync_command(scmi_channel_t *ch)
 	dmbst();
 
 	ch->info->ring_doorbell(ch->info);
+}
+
+/*
+ * Private helper function to transfer ownership of channel from AP to SCP and
+ * wait for the response.
+ */
+void scmi_send_sync_command(scmi_channel_t *ch)
+{
+	scmi_post_command(ch);
+
 	/*
 	 * Ensure that the write to the doorbell register is ordered prior to
 	 * checking whether the channel is free.
@@ -60,15 +89,22 @@ void scmi_send_sync_command(scmi_channel_t *ch)
 	dmbsy();
 
 	/* Wait for channel to be free */
-	while (!SCMI_IS_CHANNEL_FREE(mbx_mem->status))
-		;
+	scmi_wait_channel_free((mailbox_mem_t *)(ch->info->scmi_mbx_mem));
+}
 
-	/*
-	 * Ensure that any read to the SCMI payload area is done after reading
-	 * mailbox status. If these 2 reads were reordered then the CPU would
-	 * read invalid payload data
-	 */
-	dmbld();
+/*
+ * Private helper function to transfer ownership of channel from AP to SCP and
+ * release exclusive access to the channel without waiting for the response,
+ * which is discarded. The next user of the channel waits for the SCP to be
+ * done with the command in scmi_get_channel(). Commands on different channels
+ * can therefore be in flight at the same time.
+ */
+void scmi_send_async_command(scmi_channel_t *ch)
+{
+	scmi_post_command(ch);
+
+	assert(ch->lock);
+	scmi_lock_release(ch->lock);
 }
 
 /*
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -144,6 +144,7 @@ typedef struct mailbox_mem {
 /* Private APIs for use within SCMI driver */
 void scmi_get_channel(scmi_channel_t *ch);
 void scmi_send_sync_command(scmi_channel_t *ch);
+void scmi_send_async_command(scmi_channel_t *ch);
 void scmi_put_channel(scmi_channel_t *ch);
 
 static inline void validate_scmi_channel(scmi_channel_t *ch)
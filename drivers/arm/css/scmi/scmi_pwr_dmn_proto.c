@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,25 +13,18 @@
 #include "scmi_private.h"
 
 /*
- * API to set the SCMI power domain power state.
+ * Private helper function to write a `set power state` command to the mailbox.
  */
-int scmi_pwr_state_set(void *p, uint32_t domain_id,
-					uint32_t scmi_pwr_state)
+static mailbox_mem_t *scmi_pwr_state_set_msg(scmi_channel_t *ch,
+		uint32_t domain_id, uint32_t scmi_pwr_state, unsigned int token)
 {
 	mailbox_mem_t *mbx_mem;
-	unsigned int token = 0;
-	int ret;
 
 	/*
 	 * Only asynchronous mode of `set power state` command is allowed on
 	 * application processors.
 	 */
 	uint32_t pwr_state_set_msg_flag = SCMI_PWR_STATE_SET_FLAG_ASYNC;
-	scmi_channel_t *ch = (scmi_channel_t *)p;
-
-	validate_scmi_channel(ch);
-
-	scmi_get_channel(ch);
 
 	mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
 	mbx_mem->msg_header = SCMI_MSG_CREATE(SCMI_PWR_DMN_PROTO_ID,
@@ -41,6 +34,26 @@ int scmi_pwr_state_set(void *p, uint32_t domain_id,
 	SCMI_PAYLOAD_ARG3(mbx_mem->payload, pwr_state_set_msg_flag,
 						domain_id, scmi_pwr_state);
 
+	return mbx_mem;
+}
+
+/*
+ * API to set the SCMI power domain power state.
+ */
+int scmi_pwr_state_set(void *p, uint32_t domain_id,
+					uint32_t scmi_pwr_state)
+{
+	mailbox_mem_t *mbx_mem;
+	unsigned int token = 0;
+	int ret;
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+
+	validate_scmi_channel(ch);
+
+	scmi_get_channel(ch);
+
+	mbx_mem = scmi_pwr_state_set_msg(ch, domain_id, scmi_pwr_state, token);
+
 	scmi_send_sync_command(ch);
 
 	/* Get the return values */
@@ -53,6 +66,26 @@ int scmi_pwr_state_set(void *p, uint32_t domain_id,
 	return ret;
 }
 
+/*
+ * API to set the SCMI power domain power state without waiting for the
+ * response of the SCP. The caller doesn't get to know whether the request was
+ * accepted, so this is meant for requests that can't fail in a way the caller
+ * could recover from, such as powering down the calling CPU.
+ */
+void scmi_pwr_state_set_async(void *p, uint32_t domain_id,
+					uint32_t scmi_pwr_state)
+{
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+
+	validate_scmi_channel(ch);
+
+	scmi_get_channel(ch);
+
+	(void)scmi_pwr_state_set_msg(ch, domain_id, scmi_pwr_state, 0U);
+
+	scmi_send_async_command(ch);
+}
+
 /*
  * API to get the SCMI power domain power state.
  */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -45,6 +45,30 @@ int scmi_sys_pwr_state_set(void *p, uint32_t flags, uint32_t system_state)
 	return ret;
 }
 
+/*
+ * API to set the SCMI system power state without waiting for the response of
+ * the SCP. The caller doesn't get to know whether the request was accepted.
+ */
+void scmi_sys_pwr_state_set_async(void *p, uint32_t flags,
+				  uint32_t system_state)
+{
+	mailbox_mem_t *mbx_mem;
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+
+	validate_scmi_channel(ch);
+
+	scmi_get_channel(ch);
+
+	mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+	mbx_mem->msg_header = SCMI_MSG_CREATE(SCMI_SYS_PWR_PROTO_ID,
+			SCMI_SYS_PWR_STATE_SET_MSG, 0U);
+	mbx_mem->len = SCMI_SYS_PWR_STATE_SET_MSG_LEN;
+	mbx_mem->flags = SCMI_FLAG_RESP_POLL;
+	SCMI_PAYLOAD_ARG2(mbx_mem->payload, flags, system_state);
+
+	scmi_send_async_command(ch);
+}
+
 /*
  * API to get the SCMI system power state
  */
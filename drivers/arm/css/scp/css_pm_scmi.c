@@ -79,10 +79,7 @@ static scmi_channel_t scmi_channels[PLAT_ARM_SCMI_CHANNEL_COUNT];
  */
 static uint32_t default_scmi_channel_id;
 
-/*
- * TODO: Allow use of channel specific lock instead of using a single lock for
- * all the channels.
- */
+/* The locks of the SCMI channels, one per channel. */
 ARM_SCMI_INSTANTIATE_LOCK;
 
 /*
@@ -108,23 +105,22 @@ static void css_scp_core_pos_to_scmi_channel(unsigned int core_pos,
  */
 void css_scp_suspend(const struct psci_power_state *target_state)
 {
-	int ret;
-
 	/* At least power domain level 0 should be specified to be suspended */
 	assert(target_state->pwr_domain_state[ARM_PWR_LVL0] ==
 						ARM_LOCAL_STATE_OFF);
 
+	/*
+	 * The power down requests below are not waited for: the SCP only acts
+	 * on them once this CPU has entered WFI, so there is no need to stall
+	 * it for the round trip to the SCP.
+	 */
+
 	/* Check if power down at system power domain level is requested */
 	if (css_system_pwr_state(target_state) == ARM_LOCAL_STATE_OFF) {
 		/* Issue SCMI command for SYSTEM_SUSPEND on all SCMI channels */
-		ret = scmi_sys_pwr_state_set(
+		scmi_sys_pwr_state_set_async(
 				scmi_handles[default_scmi_channel_id],
 				SCMI_SYS_PWR_FORCEFUL_REQ, SCMI_SYS_PWR_SUSPEND);
-		if (ret != SCMI_E_SUCCESS) {
-			ERROR("SCMI system power domain suspend return 0x%x unexpected\n",
-					ret);
-			panic();
-		}
 		return;
 	}
 #if !HW_ASSISTED_COHERENCY
@@ -158,14 +154,8 @@ void css_scp_suspend(const struct psci_power_state *target_state)
 
 	css_scp_core_pos_to_scmi_channel(plat_my_core_pos(),
 			&domain_id, &channel_id);
-	ret = scmi_pwr_state_set(scmi_handles[channel_id],
+	scmi_pwr_state_set_async(scmi_handles[channel_id],
 		domain_id, scmi_pwr_state);
-
-	if (ret != SCMI_E_SUCCESS) {
-		ERROR("SCMI set power state command return 0x%x unexpected\n",
-				ret);
-		panic();
-	}
 #endif
 }
 
@@ -176,7 +166,6 @@ void css_scp_suspend(const struct psci_power_state *target_state)
 void css_scp_off(const struct psci_power_state *target_state)
 {
 	unsigned int lvl = 0, channel_id, domain_id;
-	int ret;
 	uint32_t scmi_pwr_state = 0;
 
 	/* At-least the CPU level should be specified to be OFF */
@@ -198,15 +187,14 @@ void css_scp_off(const struct psci_power_state *target_state)
 
 	SCMI_SET_PWR_STATE_MAX_PWR_LVL(scmi_pwr_state, lvl - 1);
 
+	/*
+	 * Don't wait for the response, the SCP powers the CPU down once it has
+	 * entered WFI.
+	 */
 	css_scp_core_pos_to_scmi_channel(plat_my_core_pos(),
 			&domain_id, &channel_id);
-	ret = scmi_pwr_state_set(scmi_handles[channel_id],
+	scmi_pwr_state_set_async(scmi_handles[channel_id],
 		domain_id, scmi_pwr_state);
-	if (ret != SCMI_E_QUEUED && ret != SCMI_E_SUCCESS) {
-		ERROR("SCMI set power state command return 0x%x unexpected\n",
-				ret);
-		panic();
-	}
 }
 
 /*
@@ -391,7 +379,7 @@ void __init plat_arm_pwrc_setup(void)
 		INFO("Initializing SCMI driver on channel %d\n", idx);
 
 		scmi_channels[idx].info = plat_css_get_scmi_info(idx);
-		scmi_channels[idx].lock = ARM_SCMI_LOCK_GET_INSTANCE;
+		scmi_channels[idx].lock = ARM_SCMI_LOCK_GET_INSTANCE(idx);
 		scmi_handles[idx] = scmi_init(&scmi_channels[idx]);
 
 		if (scmi_handles[idx] == NULL) {
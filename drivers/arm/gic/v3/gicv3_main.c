@@ -46,6 +46,19 @@ static bool is_sgi_ppi(unsigned int id);
 #define SAVE_GICR_REG(base, ctx, name, i)	\
 	(ctx)->gicr_##name[(i)] = gicr_read_##name((base), (i))
 
+/*
+ * Writing zero to the set-enable, set-pending and set-active registers has no
+ * effect, so the restore only writes the ones that have a bit set. Most
+ * interrupts are disabled, inactive and not pending, so for these registers
+ * the restore scales with the number of interrupts in use.
+ */
+#define RESTORE_GICR_SET_REG(base, ctx, name, i)			\
+	do {								\
+		if ((ctx)->gicr_##name[(i)] != 0U) {			\
+			RESTORE_GICR_REG(base, ctx, name, i);		\
+		}							\
+	} while (false)
+
 /* Helper macros to save and restore GICD registers to and from the context */
 #define RESTORE_GICD_REGS(base, ctx, intr_num, reg, REG)		\
 	do {								\
@@ -57,6 +70,18 @@ static bool is_sgi_ppi(unsigned int id);
 		}							\
 	} while (false)
 
+#define RESTORE_GICD_SET_REGS(base, ctx, intr_num, reg, REG)		\
+	do {								\
+		for (unsigned int int_id = MIN_SPI_ID; int_id < (intr_num);\
+				int_id += (1U << REG##R_SHIFT)) {	\
+			uint32_t val = (ctx)->gicd_##reg[(int_id -	\
+					MIN_SPI_ID) >> REG##R_SHIFT];	\
+			if (val != 0U) {				\
+				gicd_write_##reg((base), int_id, val);	\
+			}						\
+		}							\
+	} while (false)
+
 #define SAVE_GICD_REGS(base, ctx, intr_num, reg, REG)			\
 	do {								\
 		for (unsigned int int_id = MIN_SPI_ID; int_id < (intr_num);\
@@ -78,6 +103,19 @@ static bool is_sgi_ppi(unsigned int id);
 		}							\
 	} while (false)
 
+#define RESTORE_GICD_SET_EREGS(base, ctx, intr_num, reg, REG)		\
+	do {								\
+		for (unsigned int int_id = MIN_ESPI_ID; int_id < (intr_num);\
+				int_id += (1U << REG##R_SHIFT)) {	\
+			uint32_t val = (ctx)->gicd_##reg[(int_id -	\
+			(MIN_ESPI_ID - round_up(TOTAL_SPI_INTR_NUM,	\
+				1U << REG##R_SHIFT))) >> REG##R_SHIFT];	\
+			if (val != 0U) {				\
+				gicd_write_##reg((base), int_id, val);	\
+			}						\
+		}							\
+	} while (false)
+
 #define SAVE_GICD_EREGS(base, ctx, intr_num, reg, REG)			\
 	do {								\
 		for (unsigned int int_id = MIN_ESPI_ID; int_id < (intr_num);\
@@ -90,6 +128,7 @@ static bool is_sgi_ppi(unsigned int id);
 #else
 #define SAVE_GICD_EREGS(base, ctx, intr_num, reg, REG)
 #define RESTORE_GICD_EREGS(base, ctx, intr_num, reg, REG)
+#define RESTORE_GICD_SET_EREGS(base, ctx, intr_num, reg, REG)
 #endif /* GIC_EXT_INTID */
 
 /*******************************************************************************
@@ -709,8 +748,8 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 	 * 32 interrupt IDs per register
 	 */
 	for (i = 0U; i < ppi_regs_num; ++i) {
-		RESTORE_GICR_REG(gicr_base, rdist_ctx, ispendr, i);
-		RESTORE_GICR_REG(gicr_base, rdist_ctx, isactiver, i);
+		RESTORE_GICR_SET_REG(gicr_base, rdist_ctx, ispendr, i);
+		RESTORE_GICR_SET_REG(gicr_base, rdist_ctx, isactiver, i);
 	}
 
 	/*
@@ -721,7 +760,7 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 
 	/* 32 interrupt IDs per GICR_ISENABLER register */
 	for (i = 0U; i < ppi_regs_num; ++i) {
-		RESTORE_GICR_REG(gicr_base, rdist_ctx, isenabler, i);
+		RESTORE_GICR_SET_REG(gicr_base, rdist_ctx, isenabler, i);
 	}
 
 	/*
@@ -894,22 +933,25 @@ void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 	 */
 
 	/* Restore GICD_ISENABLER for INT_IDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLE);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLE);
 
 	/* Restore GICD_ISENABLERE for INT_IDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, isenabler, ISENABLE);
+	RESTORE_GICD_SET_EREGS(gicd_base, dist_ctx, num_eints, isenabler,
+			       ISENABLE);
 
 	/* Restore GICD_ISPENDR for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPEND);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPEND);
 
 	/* Restore GICD_ISPENDRE for INTIDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, ispendr, ISPEND);
+	RESTORE_GICD_SET_EREGS(gicd_base, dist_ctx, num_eints, ispendr,
+			       ISPEND);
 
 	/* Restore GICD_ISACTIVER for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVE);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVE);
 
 	/* Restore GICD_ISACTIVERE for INTIDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, isactiver, ISACTIVE);
+	RESTORE_GICD_SET_EREGS(gicd_base, dist_ctx, num_eints, isactiver,
+			       ISACTIVE);
 
 	/* Restore the GICD_CTLR */
 	gicd_write_ctlr(gicd_base, dist_ctx->gicd_ctlr);
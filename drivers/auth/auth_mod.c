@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -68,6 +69,122 @@ static int auth_get_param(const auth_param_type_desc_t *param_type_desc,
 	return 1;
 }
 
+/*
+ * Hash of an image computed while it is being loaded, see
+ * auth_mod_hash_stream_start().
+ */
+#define HASH_STREAM_IDLE	0
+#define HASH_STREAM_ACTIVE	1
+#define HASH_STREAM_DONE	2
+
+static struct {
+	unsigned int state;
+	unsigned int img_id;
+	unsigned int len;
+	int rc;
+} hash_stream;
+
+/*
+ * Digest of the data last authenticated by matching its hash, see
+ * auth_mod_get_img_hash().
+ */
+static struct {
+	bool valid;
+	uintptr_t base;
+	unsigned int len;
+	enum crypto_md_algo alg;
+	unsigned char hash[CRYPTO_MD_MAX_SIZE];
+} img_hash;
+
+/*
+ * Object identifier of the SHA-2 algorithms, up to the last byte, as found in
+ * the DER encoding of a DigestInfo:
+ *
+ *   DigestInfo ::= SEQUENCE {
+ *       digestAlgorithm AlgorithmIdentifier,
+ *       digest OCTET STRING
+ *   }
+ *
+ *   AlgorithmIdentifier ::= SEQUENCE {
+ *       algorithm OBJECT IDENTIFIER,
+ *       parameters ANY DEFINED BY algorithm OPTIONAL
+ *   }
+ */
+static const unsigned char sha2_oid_der[] = {
+	0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02
+};
+
+static const struct {
+	enum crypto_md_algo alg;
+	unsigned char oid_last;
+	unsigned char len;
+} sha2_digests[] = {
+	{ CRYPTO_MD_SHA256, 0x01, 32U },
+	{ CRYPTO_MD_SHA384, 0x02, 48U },
+	{ CRYPTO_MD_SHA512, 0x03, 64U },
+};
+
+/*
+ * Record the digest held in the DigestInfo of the parent image once the data
+ * has been authenticated against it, so that it can be measured without
+ * hashing it again. Only the SHA-2 algorithms, with or without NULL
+ * parameters, are recognised. Anything else is just not recorded.
+ */
+static void auth_record_img_hash(void *data_ptr, unsigned int data_len,
+				 const unsigned char *der, unsigned int der_len)
+{
+	unsigned int alg_len, i;
+	const unsigned char *p;
+
+	img_hash.valid = false;
+
+	/* SEQUENCE { SEQUENCE { OID [, NULL] }, OCTET STRING } */
+	if ((der_len < 4U) || (der[0] != 0x30U) ||
+	    (der[1] != (der_len - 2U)) || (der[2] != 0x30U)) {
+		return;
+	}
+
+	alg_len = der[3];
+	if ((alg_len != (sizeof(sha2_oid_der) + 1U)) &&
+	    (alg_len != (sizeof(sha2_oid_der) + 3U))) {
+		return;
+	}
+
+	p = &der[4];
+	if ((der_len < (4U + alg_len + 2U)) ||
+	    (memcmp(p, sha2_oid_der, sizeof(sha2_oid_der)) != 0)) {
+		return;
+	}
+	p += sizeof(sha2_oid_der);
+
+	for (i = 0U; i < ARRAY_SIZE(sha2_digests); i++) {
+		if (sha2_digests[i].oid_last == p[0]) {
+			break;
+		}
+	}
+	if (i == ARRAY_SIZE(sha2_digests)) {
+		return;
+	}
+	p++;
+
+	if ((alg_len == (sizeof(sha2_oid_der) + 3U)) &&
+	    ((p[0] != 0x05U) || (p[1] != 0x00U))) {
+		return;
+	}
+	p = &der[4U + alg_len];
+
+	if ((p[0] != 0x04U) || (p[1] != sha2_digests[i].len) ||
+	    (der_len != (4U + alg_len + 2U + sha2_digests[i].len))) {
+		return;
+	}
+
+	img_hash.base = (uintptr_t)data_ptr;
+	img_hash.len = data_len;
+	img_hash.alg = sha2_digests[i].alg;
+	(void)memcpy(img_hash.hash, &p[2], sha2_digests[i].len);
+	img_hash.valid = true;
+}
+
 /*
  * Authenticate an image by matching the data hash
  *
@@ -99,8 +216,20 @@ static int auth_hash(const auth_method_param_hash_t *param,
 {
 	void *data_ptr, *hash_der_ptr;
 	unsigned int data_len, hash_der_len;
+	bool hashed_on_load = false;
 	int rc = 0;
 
+	/* Use the result of the hash computed while loading the image, if
+	 * it covered this very image */
+	if (hash_stream.state == HASH_STREAM_DONE) {
+		hash_stream.state = HASH_STREAM_IDLE;
+		if ((hash_stream.img_id == img_desc->img_id) &&
+		    (hash_stream.len == img_len)) {
+			return_if_error(hash_stream.rc);
+			hashed_on_load = true;
+		}
+	}
+
 	/* Get the hash from the parent image. This hash will be DER encoded
 	 * and contain the hash algorithm */
 	rc = auth_get_param(param->hash, img_desc->parent,
@@ -113,10 +242,16 @@ static int auth_hash(const auth_method_param_hash_t *param,
 	return_if_error(rc);
 
 	/* Ask the crypto module to verify this hash */
-	rc = crypto_mod_verify_hash(data_ptr, data_len,
-				    hash_der_ptr, hash_der_len);
+	if (!hashed_on_load) {
+		rc = crypto_mod_verify_hash(data_ptr, data_len,
+					    hash_der_ptr, hash_der_len);
+		return_if_error(rc);
+	}
 
-	return rc;
+	/* The data matches the hash of the parent, which is hence its digest */
+	auth_record_img_hash(data_ptr, data_len, hash_der_ptr, hash_der_len);
+
+	return 0;
 }
 
 /*
@@ -353,6 +488,151 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id)
 	return 0;
 }
 
+/*
+ * Start hashing an image while it is being loaded
+ *
+ * This is only possible for raw images authenticated by matching their hash
+ * with the one in the (already authenticated) parent image. The caller must
+ * then pass the image data in order to auth_mod_hash_stream_update() as it
+ * lands in memory and call auth_mod_hash_stream_end() once it is complete.
+ * The following auth_mod_verify_img() call uses that result instead of
+ * hashing the whole image a second time.
+ *
+ * Return value:
+ *   0 = hashing started, Otherwise = not supported for this image, the hash
+ *   will be calculated by auth_mod_verify_img()
+ */
+int auth_mod_hash_stream_start(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc = NULL;
+	const auth_method_param_hash_t *param = NULL;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int rc, i;
+
+	hash_stream.state = HASH_STREAM_IDLE;
+
+	img_desc = FCONF_GET_PROPERTY(tbbr, cot, img_id);
+	if ((img_desc->img_type != IMG_RAW) ||
+	    (img_desc->img_auth_methods == NULL) ||
+	    (img_desc->parent == NULL)) {
+		return 1;
+	}
+
+	/* The hash must be the only authentication method of the image */
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		switch (img_desc->img_auth_methods[i].type) {
+		case AUTH_METHOD_NONE:
+			break;
+		case AUTH_METHOD_HASH:
+			if (param != NULL) {
+				return 1;
+			}
+			param = &img_desc->img_auth_methods[i].param.hash;
+			break;
+		default:
+			return 1;
+		}
+	}
+
+	if ((param == NULL) || (param->data->type != AUTH_PARAM_RAW_DATA)) {
+		return 1;
+	}
+
+	rc = auth_get_param(param->hash, img_desc->parent,
+			&hash_der_ptr, &hash_der_len);
+	return_if_error(rc);
+
+	rc = crypto_mod_verify_hash_init(hash_der_ptr, hash_der_len);
+	return_if_error(rc);
+
+	hash_stream.img_id = img_id;
+	hash_stream.len = 0U;
+	hash_stream.rc = 0;
+	hash_stream.state = HASH_STREAM_ACTIVE;
+
+	return 0;
+}
+
+/*
+ * Hash the next chunk of the image being loaded
+ */
+void auth_mod_hash_stream_update(void *data_ptr, unsigned int data_len)
+{
+	assert(hash_stream.state == HASH_STREAM_ACTIVE);
+
+	if ((hash_stream.rc != 0) || (data_len == 0U)) {
+		return;
+	}
+
+	hash_stream.rc = crypto_mod_verify_hash_update(data_ptr, data_len);
+	hash_stream.len += data_len;
+}
+
+/*
+ * Complete the hash of the loaded image and match it with the one in the
+ * parent image. The result is consumed by the next auth_mod_verify_img().
+ */
+void auth_mod_hash_stream_end(void)
+{
+	int rc;
+
+	assert(hash_stream.state == HASH_STREAM_ACTIVE);
+
+	rc = crypto_mod_verify_hash_final();
+	if (hash_stream.rc == 0) {
+		hash_stream.rc = rc;
+	}
+
+	hash_stream.state = HASH_STREAM_DONE;
+}
+
+/*
+ * Drop the authenticated state of any other image whose extracted parameters
+ * live in the same buffers as those of 'img_desc'.
+ *
+ * Parameters extracted from an authenticated image are kept in the buffers
+ * referenced by its 'authenticated_data' array, and the IMG_FLAG_AUTHENTICATED
+ * flag lets the children of that image skip re-authenticating it. A CoT may
+ * share those buffers between several images (e.g. the content certificate
+ * key of the TBBR key certificates), so overwriting them must also invalidate
+ * the images that previously stored their parameters there.
+ */
+static void auth_invalidate_shared_params(const auth_img_desc_t *img_desc)
+{
+	const auth_img_desc_t *other;
+	unsigned int id;
+	int i, j;
+
+	for (id = 0U; id < cot_desc_size; id++) {
+		if ((id == img_desc->img_id) ||
+		    ((auth_img_flags[id] & IMG_FLAG_AUTHENTICATED) == 0U)) {
+			continue;
+		}
+
+		other = FCONF_GET_PROPERTY(tbbr, cot, id);
+		if ((other == NULL) || (other->authenticated_data == NULL)) {
+			continue;
+		}
+
+		for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+			if (img_desc->authenticated_data[i].type_desc == NULL) {
+				continue;
+			}
+
+			for (j = 0 ; j < COT_MAX_VERIFIED_PARAMS ; j++) {
+				if ((other->authenticated_data[j].type_desc !=
+				     NULL) &&
+				    (other->authenticated_data[j].data.ptr ==
+				     img_desc->authenticated_data[i].data.ptr)) {
+					auth_img_flags[id] &=
+						~IMG_FLAG_AUTHENTICATED;
+				}
+			}
+		}
+	}
+}
+
 /*
  * Initialize the different modules in the authentication framework
  */
@@ -365,6 +645,44 @@ void auth_mod_init(void)
 	img_parser_init();
 }
 
+/*
+ * Get the digest of the data last authenticated by auth_mod_verify_img(), if
+ * it was authenticated by matching its hash with the given algorithm. This
+ * saves measuring the data by hashing it again. The digest is only available
+ * once, and only until the next image is authenticated.
+ *
+ * Parameters:
+ *   data_base, data_size: data to get the digest of
+ *   alg: message digest algorithm
+ *   output: digest of the data
+ *
+ * Return:
+ *   0 = success, Otherwise = the digest must be calculated by the caller
+ */
+int auth_mod_get_img_hash(uintptr_t data_base, uint32_t data_size,
+			  enum crypto_md_algo alg,
+			  unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	if (!img_hash.valid || (img_hash.base != data_base) ||
+	    (img_hash.len != data_size) || (img_hash.alg != alg)) {
+		return 1;
+	}
+
+	(void)memcpy(output, img_hash.hash, CRYPTO_MD_MAX_SIZE);
+	img_hash.valid = false;
+
+	return 0;
+}
+
+/*
+ * Forget the digest of the data last authenticated, once it is no longer
+ * guaranteed to match the data in memory
+ */
+void auth_mod_discard_img_hash(void)
+{
+	img_hash.valid = false;
+}
+
 /*
  * Authenticate a certificate/image
  *
@@ -387,6 +705,9 @@ int auth_mod_verify_img(unsigned int img_id,
 	/* Get the image descriptor from the chain of trust */
 	img_desc = FCONF_GET_PROPERTY(tbbr, cot, img_id);
 
+	/* Forget the digest of the previous image */
+	img_hash.valid = false;
+
 	/* Ask the parser to check the image integrity */
 	rc = img_parser_check_integrity(img_desc->img_type, img_ptr, img_len);
 	return_if_error(rc);
@@ -437,6 +758,8 @@ int auth_mod_verify_img(unsigned int img_id,
 	/* Extract the parameters indicated in the image descriptor to
 	 * authenticate the children images. */
 	if (img_desc->authenticated_data != NULL) {
+		auth_invalidate_shared_params(img_desc);
+
 		for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
 			if (img_desc->authenticated_data[i].type_desc == NULL) {
 				continue;
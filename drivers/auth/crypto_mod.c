@@ -115,6 +115,59 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
+
+/*
+ * Start the incremental verification of a hash
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared
+ *
+ * Returns CRYPTO_ERR_UNKNOWN if the library does not support it, in which case
+ * the caller must fall back to crypto_mod_verify_hash().
+ */
+int crypto_mod_verify_hash_init(void *digest_info_ptr,
+				unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+
+	if ((crypto_lib_desc.verify_hash_init == NULL) ||
+	    (crypto_lib_desc.verify_hash_update == NULL) ||
+	    (crypto_lib_desc.verify_hash_final == NULL)) {
+		return CRYPTO_ERR_UNKNOWN;
+	}
+
+	return crypto_lib_desc.verify_hash_init(digest_info_ptr,
+						digest_info_len);
+}
+
+/*
+ * Add data to the hash started by crypto_mod_verify_hash_init()
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: next chunk of data to be hashed
+ */
+int crypto_mod_verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(crypto_lib_desc.verify_hash_update != NULL);
+	assert(data_ptr != NULL);
+	assert(data_len != 0);
+
+	return crypto_lib_desc.verify_hash_update(data_ptr, data_len);
+}
+
+/*
+ * Complete the hash started by crypto_mod_verify_hash_init() and compare it
+ * with the expected one
+ */
+int crypto_mod_verify_hash_final(void)
+{
+	assert(crypto_lib_desc.verify_hash_final != NULL);
+
+	return crypto_lib_desc.verify_hash_final();
+}
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -154,19 +155,18 @@ end2:
 }
 
 /*
- * Match a hash
+ * Extract the hash algorithm and the hash value from a DigestInfo.
  *
  * Digest info is passed in DER format following the ASN.1 structure detailed
  * above.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -190,8 +190,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -202,10 +202,32 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *p, *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != 0) {
+		return rc;
+	}
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
@@ -222,6 +244,103 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 
 	return CRYPTO_SUCCESS;
 }
+
+/*
+ * Context of the hash being verified incrementally. The expected value is
+ * copied as the DigestInfo buffer may be reused before the hash completes.
+ */
+static mbedtls_md_context_t verify_md_ctx;
+static unsigned char verify_md_hash[MBEDTLS_MD_MAX_SIZE];
+static size_t verify_md_len;
+static bool verify_md_started;
+
+/*
+ * Start the incremental verification of a hash
+ *
+ * Any verification left in progress is discarded.
+ */
+static int verify_hash_init(void *digest_info_ptr,
+			    unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	if (verify_md_started) {
+		mbedtls_md_free(&verify_md_ctx);
+		verify_md_started = false;
+	}
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != 0) {
+		return rc;
+	}
+
+	mbedtls_md_init(&verify_md_ctx);
+	rc = mbedtls_md_setup(&verify_md_ctx, md_info, 0);
+	if (rc == 0) {
+		rc = mbedtls_md_starts(&verify_md_ctx);
+	}
+	if (rc != 0) {
+		mbedtls_md_free(&verify_md_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	verify_md_len = mbedtls_md_get_size(md_info);
+	memcpy(verify_md_hash, hash, verify_md_len);
+	verify_md_started = true;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Add a chunk of data to the hash being verified
+ */
+static int verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	int rc;
+
+	if (!verify_md_started) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_update(&verify_md_ctx, data_ptr, data_len);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Complete the hash being verified and match it with the expected value
+ */
+static int verify_hash_final(void)
+{
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	if (!verify_md_started) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_finish(&verify_md_ctx, data_hash);
+
+	mbedtls_md_free(&verify_md_ctx);
+	verify_md_started = false;
+
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	/* Compare values */
+	rc = memcmp(data_hash, verify_md_hash, verify_md_len);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
@@ -376,18 +495,23 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
  */
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 #if TF_MBEDTLS_USE_AES_GCM
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    auth_decrypt);
+REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash,
+		    verify_hash_init, verify_hash_update, verify_hash_final,
+		    calc_hash, auth_decrypt);
 #else
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash,
+		    verify_hash_init, verify_hash_update, verify_hash_final,
+		    calc_hash, NULL);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY
 #if TF_MBEDTLS_USE_AES_GCM
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash,
+		    verify_hash_init, verify_hash_update, verify_hash_final,
 		    auth_decrypt);
 #else
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash,
+		    verify_hash_init, verify_hash_update, verify_hash_final,
+		    NULL);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY
 REGISTER_CRYPTO_LIB(LIB_NAME, init, calc_hash);
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <platform_def.h>
@@ -171,6 +172,31 @@ static int block_seek(io_entity_t *entity, int mode, signed long long offset)
 	return 0;
 }
 
+/*
+ * Whole blocks can be transferred straight to or from the user buffer, without
+ * going through the underlying buffer, when the device allows it, the current
+ * position is at the start of a block and the user buffer is aligned to the
+ * block size, like the underlying buffer is. Only the unaligned head and tail
+ * of a transfer then need to be bounced.
+ */
+static inline bool block_is_direct(const io_block_dev_spec_t *dev_spec,
+				   uintptr_t buffer, size_t skip, size_t left)
+{
+	size_t block_size = dev_spec->block_size;
+
+	return dev_spec->direct && (skip == 0U) && (left >= block_size) &&
+	       ((buffer & (block_size - 1U)) == 0U);
+}
+
+/* Length of the direct transfer of the whole blocks of the left bytes */
+static inline size_t block_direct_length(const io_block_dev_spec_t *dev_spec,
+					 size_t left)
+{
+	size_t request = left & ~(dev_spec->block_size - 1U);
+
+	return MIN(request, dev_spec->direct_max_length);
+}
+
 /*
  * This function allows the caller to read any number of bytes
  * from any position. It hides from the caller that the low level
@@ -240,6 +266,11 @@ static int block_seek(io_entity_t *entity, int mode, signed long long offset)
  *
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
+ *
+ * When the device allows it and the user buffer is block-aligned, the whole
+ * blocks are read directly into it, in requests of at most direct_max_length
+ * bytes, and only the partial blocks at either end, if any, go through the
+ * underlying buffer.
  */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
@@ -296,6 +327,24 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
+		if (block_is_direct(cur->dev_spec, buffer + count, skip,
+				    left)) {
+			/*
+			 * Read all the whole blocks left straight into the
+			 * user buffer, without going through the underlying
+			 * buffer.
+			 */
+			request = block_direct_length(cur->dev_spec, left);
+			nbytes = ops->read(lba, buffer + count, request);
+			if ((nbytes == 0U) || (nbytes > request)) {
+				return -EIO;
+			}
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
 		if ((skip + left) > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
@@ -409,6 +458,24 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
+		if (block_is_direct(cur->dev_spec, buffer + count, skip,
+				    left)) {
+			/*
+			 * Write all the whole blocks left straight from the
+			 * user buffer, without going through the underlying
+			 * buffer.
+			 */
+			request = block_direct_length(cur->dev_spec, left);
+			nbytes = ops->write(lba, buffer + count, request);
+			if ((nbytes == 0U) || (nbytes > request)) {
+				return -EIO;
+			}
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
 		if ((skip + left) > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
@@ -519,6 +586,9 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 	       (is_power_of_2(block_size) != 0U) &&
 	       ((buffer->offset % block_size) == 0U) &&
 	       ((buffer->length % block_size) == 0U));
+	assert(!cur->dev_spec->direct ||
+	       ((cur->dev_spec->direct_max_length >= block_size) &&
+		((cur->dev_spec->direct_max_length % block_size) == 0U)));
 
 	*dev_info = info;	/* cast away const */
 	(void)block_size;
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2014-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -25,6 +26,14 @@
 #define MAX_FIP_DEVICES		1
 #endif
 
+/*
+ * Number of ToC entries cached per FIP device. Files whose entry is past the
+ * cached ones are looked up in the backend.
+ */
+#ifndef FIP_TOC_INDEX_ENTRIES
+#define FIP_TOC_INDEX_ENTRIES	32
+#endif
+
 /* Useful for printing UUIDs when debugging.*/
 #define PRINT_UUID2(x)								\
 	"%08x-%04hx-%04hx-%02hhx%02hhx-%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",	\
@@ -36,10 +45,11 @@
 typedef struct {
 	unsigned int file_pos;
 	fip_toc_entry_t entry;
+	uintptr_t backend_handle;
 } fip_file_state_t;
 
 /*
- * Maintain dev_spec per FIP Device
+ * Maintain dev_spec and a copy of the ToC per FIP Device
  * TODO - Add backend handles and file state
  * per FIP device here once backends like io_memmap
  * can support multiple open files
@@ -47,6 +57,11 @@ typedef struct {
 typedef struct {
 	uintptr_t dev_spec;
 	uint16_t plat_toc_flag;
+	/* Number of valid entries in toc */
+	unsigned int toc_entries;
+	/* Set if toc holds all the entries of the ToC */
+	bool toc_complete;
+	fip_toc_entry_t toc[FIP_TOC_INDEX_ENTRIES];
 } fip_dev_state_t;
 
 /*
@@ -54,7 +69,9 @@ typedef struct {
  * as backends like io_memmap don't support
  * multiple open files. The file state and
  * backend handle should be maintained per FIP device
- * if the same support is available in the backend
+ * if the same support is available in the backend.
+ * The backend is kept open while a file is open, so
+ * that reading it in chunks does not reopen it.
  */
 static fip_file_state_t current_fip_file = {0};
 static uintptr_t backend_dev_handle;
@@ -212,7 +229,48 @@ static int fip_dev_open(const uintptr_t dev_spec,
 }
 
 
-/* Do some basic package checks. */
+/*
+ * Copy the ToC, which follows the header, into the device state with a single
+ * read of the backend. The copy ends at the null entry closing the ToC or when
+ * the copy is full.
+ */
+static int fip_read_toc(uintptr_t backend_handle, fip_dev_state_t *state)
+{
+	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
+	size_t toc_size = sizeof(state->toc);
+	size_t fip_size;
+	size_t bytes_read;
+	unsigned int i;
+	int result;
+
+	state->toc_entries = 0U;
+	state->toc_complete = false;
+
+	/* Do not read past the end of the backend, if its size is known */
+	if ((io_size(backend_handle, &fip_size) == 0) &&
+	    (fip_size >= sizeof(fip_toc_header_t))) {
+		toc_size = MIN(toc_size, fip_size - sizeof(fip_toc_header_t));
+	}
+
+	result = io_read(backend_handle, (uintptr_t)&state->toc[0], toc_size,
+			 &bytes_read);
+	if (result != 0) {
+		WARN("Failed to read FIP ToC (%i)\n", result);
+		return result;
+	}
+
+	for (i = 0U; i < (bytes_read / sizeof(fip_toc_entry_t)); i++) {
+		if (compare_uuids(&state->toc[i].uuid, &uuid_null) == 0) {
+			state->toc_complete = true;
+			break;
+		}
+	}
+	state->toc_entries = i;
+
+	return 0;
+}
+
+/* Do some basic package checks and cache the ToC. */
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
 	int result;
@@ -225,6 +283,8 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 	assert(dev_info != NULL);
 
 	state = (fip_dev_state_t *)dev_info->info;
+	state->toc_entries = 0U;
+	state->toc_complete = false;
 
 	/* Obtain a reference to the image by querying the platform layer */
 	result = plat_get_image_source(image_id, &backend_dev_handle,
@@ -258,6 +318,8 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 			 * bits [32-47] in fip header.
 			 */
 			state->plat_toc_flag = (header.flags >> 32) & 0xffff;
+
+			result = fip_read_toc(backend_handle, state);
 		}
 	}
 
@@ -280,6 +342,44 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 }
 
 
+/*
+ * Look up a file in the ToC entries that are not cached in the device state,
+ * reading them from the backend.
+ */
+static int fip_find_uncached_entry(uintptr_t backend_handle,
+				   const fip_dev_state_t *state,
+				   const uuid_t *uuid, fip_toc_entry_t *entry)
+{
+	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
+	size_t bytes_read;
+	int result;
+
+	/* Seek past the FIP header and cached entries into the ToC */
+	result = io_seek(backend_handle, IO_SEEK_SET,
+			 (signed long long)(sizeof(fip_toc_header_t) +
+			 (state->toc_entries * sizeof(fip_toc_entry_t))));
+	if (result != 0) {
+		WARN("fip_file_open: failed to seek\n");
+		return -ENOENT;
+	}
+
+	do {
+		result = io_read(backend_handle, (uintptr_t)entry,
+				 sizeof(*entry), &bytes_read);
+		if (result != 0) {
+			WARN("Failed to read FIP (%i)\n", result);
+			return result;
+		}
+
+		if (compare_uuids(&entry->uuid, uuid) == 0) {
+			return 0;
+		}
+	} while (compare_uuids(&entry->uuid, &uuid_null) != 0);
+
+	/* Did not find the file in the FIP. */
+	return -ENOENT;
+}
+
 /* Open a file for access from package. */
 static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 			 io_entity_t *entity)
@@ -287,13 +387,16 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	int result;
 	uintptr_t backend_handle;
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
-	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
-	size_t bytes_read;
-	int found_file = 0;
+	const fip_dev_state_t *state;
+	bool found_file = false;
+	unsigned int i;
 
+	assert(dev_info != NULL);
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
 
+	state = (fip_dev_state_t *)dev_info->info;
+
 	/* Can only have one file open at a time for the moment. We need to
 	 * track state like file cursor position. We know the header lives at
 	 * offset zero, so this entry should never be zero for an active file.
@@ -305,6 +408,20 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		return -ENFILE;
 	}
 
+	/* Look the file up in the ToC cached by fip_dev_init() */
+	for (i = 0U; i < state->toc_entries; i++) {
+		if (compare_uuids(&state->toc[i].uuid, &uuid_spec->uuid) == 0) {
+			current_fip_file.entry = state->toc[i];
+			found_file = true;
+			break;
+		}
+	}
+
+	if (!found_file && state->toc_complete) {
+		/* Did not find the file in the FIP. */
+		return -ENOENT;
+	}
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -314,51 +431,40 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		goto fip_file_open_exit;
 	}
 
-	/* Seek past the FIP header into the Table of Contents */
+	if (!found_file) {
+		result = fip_find_uncached_entry(backend_handle, state,
+						 &uuid_spec->uuid,
+						 &current_fip_file.entry);
+		if (result != 0) {
+			goto fip_file_open_close;
+		}
+	}
+
+	/* Seek to the position in the FIP where the payload lives */
 	result = io_seek(backend_handle, IO_SEEK_SET,
-			 (signed long long)sizeof(fip_toc_header_t));
+			 (signed long long)current_fip_file.entry.offset_address);
 	if (result != 0) {
 		WARN("fip_file_open: failed to seek\n");
 		result = -ENOENT;
 		goto fip_file_open_close;
 	}
 
-	found_file = 0;
-	do {
-		result = io_read(backend_handle,
-				 (uintptr_t)&current_fip_file.entry,
-				 sizeof(current_fip_file.entry),
-				 &bytes_read);
-		if (result == 0) {
-			if (compare_uuids(&current_fip_file.entry.uuid,
-					  &uuid_spec->uuid) == 0) {
-				found_file = 1;
-			}
-		} else {
-			WARN("Failed to read FIP (%i)\n", result);
-			goto fip_file_open_close;
-		}
-	} while ((found_file == 0) &&
-			(compare_uuids(&current_fip_file.entry.uuid,
-				&uuid_null) != 0));
-
-	if (found_file == 1) {
-		/* All fine. Update entity info with file state and return. Set
-		 * the file position to 0. The 'current_fip_file.entry' holds
-		 * the base and size of the file.
-		 */
-		current_fip_file.file_pos = 0;
-		entity->info = (uintptr_t)&current_fip_file;
-	} else {
-		/* Did not find the file in the FIP. */
-		current_fip_file.entry.offset_address = 0;
-		result = -ENOENT;
-	}
+	/* All fine. Update entity info with file state and return. Set
+	 * the file position to 0. The 'current_fip_file.entry' holds
+	 * the base and size of the file. The backend is kept open until
+	 * the file is closed.
+	 */
+	current_fip_file.file_pos = 0;
+	current_fip_file.backend_handle = backend_handle;
+	entity->info = (uintptr_t)&current_fip_file;
+
+	return 0;
 
  fip_file_open_close:
 	io_close(backend_handle);
 
  fip_file_open_exit:
+	current_fip_file.entry.offset_address = 0;
 	return result;
 }
 
@@ -381,52 +487,29 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 {
 	int result;
 	fip_file_state_t *fp;
-	size_t file_offset;
 	size_t bytes_read;
-	uintptr_t backend_handle;
 
 	assert(entity != NULL);
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
 
-	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != 0) {
-		WARN("Failed to open FIP (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_read_exit;
-	}
-
 	fp = (fip_file_state_t *)entity->info;
 
-	/* Seek to the position in the FIP where the payload lives */
-	file_offset = fp->entry.offset_address + fp->file_pos;
-	result = io_seek(backend_handle, IO_SEEK_SET,
-			 (signed long long)file_offset);
-	if (result != 0) {
-		WARN("fip_file_read: failed to seek\n");
-		result = -ENOENT;
-		goto fip_file_read_close;
-	}
-
-	result = io_read(backend_handle, buffer, length, &bytes_read);
+	/*
+	 * The backend was left at the position of the payload matching
+	 * fp->file_pos by fip_file_open() and the previous reads.
+	 */
+	result = io_read(fp->backend_handle, buffer, length, &bytes_read);
 	if (result != 0) {
 		/* We cannot read our data. Fail. */
 		WARN("Failed to read payload (%i)\n", result);
 		result = -ENOENT;
-		goto fip_file_read_close;
 	} else {
 		/* Set caller length and new file position. */
 		*length_read = bytes_read;
 		fp->file_pos += bytes_read;
 	}
 
-/* Close the backend. */
- fip_file_read_close:
-	io_close(backend_handle);
-
- fip_file_read_exit:
 	return result;
 }
 
@@ -438,6 +521,8 @@ static int fip_file_close(io_entity_t *entity)
 	 * If we had malloc() we would free() here.
 	 */
 	if (current_fip_file.entry.offset_address != 0U) {
+		/* Close the backend. */
+		io_close(current_fip_file.backend_handle);
 		zeromem(&current_fip_file, sizeof(current_fip_file));
 	}
 
@@ -184,6 +184,17 @@ int io_dev_init(uintptr_t dev_handle, const uintptr_t init_params)
 	return result;
 }
 
+/* Return the type of an opened device */
+io_type_t io_dev_type(uintptr_t dev_handle)
+{
+	assert(dev_handle != (uintptr_t)NULL);
+	assert(is_valid_dev(dev_handle));
+
+	io_dev_info_t *dev = (io_dev_info_t *)dev_handle;
+
+	return dev->funcs->type();
+}
+
 /* Close a connection to a device */
 int io_dev_close(uintptr_t dev_handle)
 {
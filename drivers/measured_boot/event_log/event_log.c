@@ -11,6 +11,7 @@
 
 #include <common/bl_common.h>
 #include <common/debug.h>
+#include <drivers/auth/auth_mod.h>
 #include <drivers/auth/crypto_mod.h>
 #include <drivers/measured_boot/event_log/event_log.h>
 
@@ -294,10 +295,16 @@ int event_log_measure_and_record(uintptr_t data_base, uint32_t data_size,
 	}
 	assert(metadata_ptr->id != EVLOG_INVALID_ID);
 
-	/* Measure the payload with algorithm selected by EventLog driver */
-	rc = event_log_measure(data_base, data_size, hash_data);
-	if (rc != 0) {
-		return rc;
+	/*
+	 * Measure the payload with algorithm selected by EventLog driver,
+	 * unless its digest was already computed to authenticate it.
+	 */
+	if (auth_mod_get_img_hash(data_base, data_size, CRYPTO_MD_ID,
+				  hash_data) != 0) {
+		rc = event_log_measure(data_base, data_size, hash_data);
+		if (rc != 0) {
+			return rc;
+		}
 	}
 
 	event_log_record(hash_data, EV_POST_CODE, metadata_ptr);
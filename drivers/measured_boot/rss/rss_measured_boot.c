@@ -8,6 +8,7 @@
 #include <string.h>
 
 #include <common/debug.h>
+#include <drivers/auth/auth_mod.h>
 #include <drivers/auth/crypto_mod.h>
 #include <drivers/measured_boot/rss/rss_measured_boot.h>
 #include <lib/psa/measured_boot.h>
@@ -77,11 +78,14 @@ int rss_mboot_measure_and_record(uintptr_t data_base, uint32_t data_size,
 		return 0;
 	}
 
-	/* Calculate hash */
-	rc = crypto_mod_calc_hash(CRYPTO_MD_ID,
-				  (void *)data_base, data_size, hash_data);
-	if (rc != 0) {
-		return rc;
+	/* Calculate hash, unless it was already computed to authenticate it */
+	if (auth_mod_get_img_hash(data_base, data_size, CRYPTO_MD_ID,
+				  hash_data) != 0) {
+		rc = crypto_mod_calc_hash(CRYPTO_MD_ID, (void *)data_base,
+					  data_size, hash_data);
+		if (rc != 0) {
+			return rc;
+		}
 	}
 
 	ret = rss_measured_boot_extend_measurement(
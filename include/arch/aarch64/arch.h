@@ -244,6 +244,10 @@
 #define ID_AA64ISAR0_RNDR_SHIFT	U(60)
 #define ID_AA64ISAR0_RNDR_MASK	ULL(0xf)
 
+#define ID_AA64ISAR0_TLB_SHIFT	U(56)
+#define ID_AA64ISAR0_TLB_MASK	ULL(0xf)
+#define ID_AA64ISAR0_TLB_RANGE	ULL(2)
+
 /* ID_AA64ISAR1_EL1 definitions */
 #define ID_AA64ISAR1_EL1		S3_0_C0_C6_1
 
@@ -932,6 +936,31 @@
 #define TLBI_ADDR_MASK		ULL(0x00000FFFFFFFFFFF)
 #define TLBI_ADDR(x)		(((x) >> TLBI_ADDR_SHIFT) & TLBI_ADDR_MASK)
 
+/* SIZE field of the TLBI RPA* instructions */
+#define TLBI_RPA_SIZE_SHIFT	U(44)
+
+/*
+ * Fields of the operand of the TLBI R*VA* instructions, for a 4KB granule. The
+ * range covers (NUM + 1) * 2^(5 * SCALE + 1) pages starting at BaseADDR.
+ */
+#define TLBI_RANGE_TG_4KB	(ULL(1) << 46)
+#define TLBI_RANGE_SCALE_SHIFT	U(44)
+#define TLBI_RANGE_NUM_SHIFT	U(39)
+#define TLBI_RANGE_NUM_MASK	ULL(0x1f)
+#define TLBI_RANGE_ADDR_MASK	ULL(0x1FFFFFFFFF)
+#define TLBI_RANGE_SCALE_MAX	U(3)
+
+#define TLBI_RANGE_PAGES(num, scale)					\
+	(((unsigned long)(num) + 1UL) << ((5U * (scale)) + 1U))
+#define TLBI_RANGE_MAX_PAGES						\
+	TLBI_RANGE_PAGES(TLBI_RANGE_NUM_MASK, TLBI_RANGE_SCALE_MAX)
+
+#define TLBI_RANGE(va, num, scale)					\
+	(TLBI_RANGE_TG_4KB |						\
+	 ((uint64_t)(scale) << TLBI_RANGE_SCALE_SHIFT) |		\
+	 ((uint64_t)(num) << TLBI_RANGE_NUM_SHIFT) |			\
+	 (((uint64_t)(va) >> TLBI_ADDR_SHIFT) & TLBI_RANGE_ADDR_MASK))
+
 /*******************************************************************************
  * Definitions of register offsets and fields in the CNTCTLBase Frame of the
  * system level implementation of the Generic Timer.
@@ -12,6 +12,7 @@
 #include <lib/utils_def.h>
 
 #ifndef __ASSEMBLER__
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <lib/cassert.h>
@@ -163,10 +164,36 @@ typedef struct meminfo {
 	size_t total_size;
 } meminfo_t;
 
+/*******************************************************************************
+ * Consumer of the data of an image while it is loaded. Once registered with
+ * set_image_stream(), load_auth_image() reads the image in chunks into 'buf'
+ * and hands them to update() in order, instead of keeping the image in memory.
+ * start() may move image_data to where the consumer produces its output, and
+ * discard() must erase that output and undo start().
+ *
+ * Streaming is only used when the image does not need to be whole in memory:
+ * with TRUSTED_BOARD_BOOT, only for images that are hashed while they are
+ * loaded, and never with MEASURED_BOOT. Otherwise the image is loaded at
+ * image_base as usual, and 'streamed' is left false.
+ *
+ * Note that a consumer such as the image decompressor (IMAGE_DECOMPRESS_STREAM)
+ * parses the data before the image is authenticated.
+ ******************************************************************************/
+typedef struct image_stream {
+	uintptr_t buf;
+	size_t buf_size;
+	int (*start)(image_info_t *image_data);
+	int (*update)(uintptr_t chunk, size_t len);
+	int (*end)(void);
+	void (*discard)(image_info_t *image_data);
+	bool streamed;
+} image_stream_t;
+
 /*******************************************************************************
  * Function & variable prototypes
  ******************************************************************************/
 int load_auth_image(unsigned int image_id, image_info_t *image_data);
+void set_image_stream(image_info_t *image_data, image_stream_t *stream);
 
 #if TRUSTED_BOARD_BOOT && defined(DYN_DISABLE_AUTH)
 /*
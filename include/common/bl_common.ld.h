@@ -37,7 +37,11 @@
 	. = ALIGN(STRUCT_ALIGN);			\
 	__RT_SVC_DESCS_START__ = .;			\
 	KEEP(*(rt_svc_descs))				\
-	__RT_SVC_DESCS_END__ = .;
+	__RT_SVC_DESCS_END__ = .;			\
+	. = ALIGN(STRUCT_ALIGN);			\
+	__RT_SVC_FAST_DESCS_START__ = .;		\
+	KEEP(*(rt_svc_fast_descs))			\
+	__RT_SVC_FAST_DESCS_END__ = .;
 
 #if SPMC_AT_EL3
 #define EL3_LP_DESCS					\
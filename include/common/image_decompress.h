@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -16,8 +16,22 @@ typedef int (decompressor_t)(uintptr_t *in_buf, size_t in_len,
 			     uintptr_t *out_buf, size_t out_len,
 			     uintptr_t work_buf, size_t work_len);
 
+/*
+ * Decompressor fed with the compressed data piece by piece, as it is read.
+ * end() returns the end of the output in 'out_buf'.
+ */
+typedef struct decompressor_stream {
+	int (*start)(uintptr_t out_buf, size_t out_len,
+		     uintptr_t work_buf, size_t work_len);
+	int (*update)(uintptr_t in_buf, size_t in_len);
+	int (*end)(uintptr_t *out_buf);
+} decompressor_stream_t;
+
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *decompressor);
+#if IMAGE_DECOMPRESS_STREAM
+void image_decompress_stream_init(const decompressor_stream_t *stream);
+#endif
 void image_decompress_prepare(struct image_info *info);
 int image_decompress(struct image_info *info);
 
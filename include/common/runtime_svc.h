@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -31,6 +31,35 @@
 #endif /* __aarch64__ */
 #define SIZEOF_RT_SVC_DESC	(U(1) << RT_SVC_SIZE_LOG2)
 
+/*
+ * Constants to allow the assembler access a fast SMC handler descriptor
+ */
+#define RT_SVC_FAST_DESC_FID	U(0)
+#ifdef __aarch64__
+#define RT_SVC_FAST_DESC_HANDLE	U(8)
+#define RT_SVC_FAST_DESC_SIZE_LOG2	U(4)
+#else
+#define RT_SVC_FAST_DESC_HANDLE	U(4)
+#define RT_SVC_FAST_DESC_SIZE_LOG2	U(3)
+#endif /* __aarch64__ */
+#define SIZEOF_RT_SVC_FAST_DESC	(U(1) << RT_SVC_FAST_DESC_SIZE_LOG2)
+
+/* Maximum number of fast SMC handlers, including one terminator per entity */
+#define MAX_RT_SVC_FAST_DESCS	U(32)
+
+/*
+ * Fast SMC handlers are called straight from the AArch64 BL31 exception vector,
+ * with only the registers that are not preserved across a procedure call saved.
+ * They are bypassed when EL3 has to do more than that on entry and exit: when
+ * it uses pointer authentication or when it restores the dynamic CVE-2018-3639
+ * mitigation state on exit.
+ */
+#if defined(__aarch64__) && !ENABLE_PAUTH && !DYNAMIC_WORKAROUND_CVE_2018_3639
+#define RT_SVC_FAST_PATH	1
+#else
+#define RT_SVC_FAST_PATH	0
+#endif
+
 
 /*
  * In SMCCC 1.X, the function identifier has 6 bits for the owning entity number
@@ -67,6 +96,24 @@ typedef struct rt_svc_desc {
 	rt_svc_handle_t handle;
 } rt_svc_desc_t;
 
+/*
+ * Descriptor of a fast SMC handler. The handler is called for an exact fast SMC
+ * function ID, with the SVE hint bit cleared, instead of the handler of the
+ * runtime service owning it. The handler has the same prototype and returns
+ * values in the same way as a runtime service handler, with the SMC_RETx
+ * macros, but it must neither switch to another world nor change the EL3
+ * state of the context (SPSR_EL3, ELR_EL3, SCR_EL3), nor access x19-x29 in the
+ * context, which are not saved. Fast handlers must also complete in bounded
+ * time without taking any lock, so that they cannot delay the other SMCs of
+ * the CPU. Only calls that return a value computed locally qualify. A fast
+ * handler must also handle the function ID when called by the owning runtime
+ * service, which is the case when the fast path is not used.
+ */
+typedef struct rt_svc_fast_desc {
+	uint32_t smc_fid;
+	rt_svc_handle_t handle;
+} rt_svc_fast_desc_t;
+
 /*
  * Convenience macros to declare a service descriptor
  */
@@ -81,6 +128,13 @@ typedef struct rt_svc_desc {
 			.handle = (_smch)				\
 		}
 
+#define DECLARE_RT_SVC_FAST(_name, _fid, _smch)				\
+	static const rt_svc_fast_desc_t __svc_fast_desc_ ## _name	\
+		__section("rt_svc_fast_descs") __used = {		\
+			.smc_fid = (_fid),				\
+			.handle = (_smch)				\
+		}
+
 /*
  * Compile time assertions related to the 'rt_svc_desc' structure to:
  * 1. ensure that the assembler and the compiler view of the size
@@ -97,6 +151,21 @@ CASSERT(RT_SVC_DESC_INIT == __builtin_offsetof(rt_svc_desc_t, init), \
 CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 	assert_rt_svc_desc_handle_offset_mismatch);
 
+/*
+ * Compile time assertions ensuring that the assembler and the compiler view of
+ * the 'rt_svc_fast_desc' structure are the same.
+ */
+CASSERT((sizeof(rt_svc_fast_desc_t) == SIZEOF_RT_SVC_FAST_DESC), \
+	assert_sizeof_rt_svc_fast_desc_mismatch);
+CASSERT(RT_SVC_FAST_DESC_FID == __builtin_offsetof(rt_svc_fast_desc_t, smc_fid), \
+	assert_rt_svc_fast_desc_fid_offset_mismatch);
+CASSERT(RT_SVC_FAST_DESC_HANDLE == \
+	__builtin_offsetof(rt_svc_fast_desc_t, handle), \
+	assert_rt_svc_fast_desc_handle_offset_mismatch);
+
+/* The index of a group of fast SMC handlers must fit in 7 bits */
+CASSERT(MAX_RT_SVC_FAST_DESCS <= 128U, assert_max_rt_svc_fast_descs);
+
 
 /*
  * This function combines the call type and the owning entity number
@@ -130,9 +199,15 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid, void *cookie, void *handle,
 						unsigned int flags);
 IMPORT_SYM(uintptr_t, __RT_SVC_DESCS_START__,		RT_SVC_DESCS_START);
 IMPORT_SYM(uintptr_t, __RT_SVC_DESCS_END__,		RT_SVC_DESCS_END);
+IMPORT_SYM(uintptr_t, __RT_SVC_FAST_DESCS_START__,	RT_SVC_FAST_DESCS_START);
+IMPORT_SYM(uintptr_t, __RT_SVC_FAST_DESCS_END__,	RT_SVC_FAST_DESCS_END);
 void init_crash_reporting(void);
 
 extern uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
+#if RT_SVC_FAST_PATH
+extern uint8_t rt_svc_fast_descs_indices[MAX_RT_SVCS];
+extern rt_svc_fast_desc_t rt_svc_fast_descs[MAX_RT_SVC_FAST_DESCS];
+#endif
 
 #endif /*__ASSEMBLER__*/
 #endif /* RUNTIME_SVC_H */
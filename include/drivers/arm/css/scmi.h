@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -151,9 +151,12 @@ int scmi_proto_version(void *p, uint32_t proto_id, uint32_t *version);
 
 /*
  * Power domain protocol commands. Refer to the SCMI specification for more
- * details on these commands.
+ * details on these commands. The `_async` variants return as soon as the
+ * command has been handed over to the SCP, without waiting for its response.
  */
 int scmi_pwr_state_set(void *p, uint32_t domain_id, uint32_t scmi_pwr_state);
+void scmi_pwr_state_set_async(void *p, uint32_t domain_id,
+			      uint32_t scmi_pwr_state);
 int scmi_pwr_state_get(void *p, uint32_t domain_id, uint32_t *scmi_pwr_state);
 
 /*
@@ -161,6 +164,8 @@ int scmi_pwr_state_get(void *p, uint32_t domain_id, uint32_t *scmi_pwr_state);
  * details on these commands.
  */
 int scmi_sys_pwr_state_set(void *p, uint32_t flags, uint32_t system_state);
+void scmi_sys_pwr_state_set_async(void *p, uint32_t flags,
+				  uint32_t system_state);
 int scmi_sys_pwr_state_get(void *p, uint32_t *system_state);
 
 /* SCMI AP core configuration protocol commands. */
@@ -10,6 +10,7 @@
 #include <common/tbbr/cot_def.h>
 #include <common/tbbr/tbbr_img_def.h>
 #include <drivers/auth/auth_common.h>
+#include <drivers/auth/crypto_mod.h>
 #include <drivers/auth/img_parser_mod.h>
 
 #include <lib/utils_def.h>
@@ -55,6 +56,26 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+int auth_mod_hash_stream_start(unsigned int img_id);
+void auth_mod_hash_stream_update(void *data_ptr, unsigned int data_len);
+void auth_mod_hash_stream_end(void);
+#if TRUSTED_BOARD_BOOT
+int auth_mod_get_img_hash(uintptr_t data_base, uint32_t data_size,
+			  enum crypto_md_algo alg,
+			  unsigned char output[CRYPTO_MD_MAX_SIZE]);
+void auth_mod_discard_img_hash(void);
+#else
+static inline int auth_mod_get_img_hash(uintptr_t data_base,
+					uint32_t data_size,
+					enum crypto_md_algo alg,
+					unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	return 1;
+}
+static inline void auth_mod_discard_img_hash(void)
+{
+}
+#endif /* TRUSTED_BOARD_BOOT */
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t pointers */
 #define REGISTER_COT(_cot) \
@@ -62,6 +62,16 @@ CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 	/* Verify a hash. Return one of the 'enum crypto_ret_value' options */
 	int (*verify_hash)(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Verify a hash incrementally: start a digest matching the algorithm
+	 * of the DigestInfo, feed it the data in chunks and compare the result
+	 * at the end. Only one digest is in progress at a time. These are
+	 * optional and may be NULL. Return one of the 'enum crypto_ret_value'
+	 * options */
+	int (*verify_hash_init)(void *digest_info_ptr,
+				unsigned int digest_info_len);
+	int (*verify_hash_update)(void *data_ptr, unsigned int data_len);
+	int (*verify_hash_final)(void);
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
@@ -102,6 +112,10 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *pk_ptr, unsigned int pk_len);
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_verify_hash_init(void *digest_info_ptr,
+				unsigned int digest_info_len);
+int crypto_mod_verify_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_verify_hash_final(void);
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
@@ -122,23 +136,31 @@ int crypto_mod_calc_hash(enum crypto_md_algo alg, void *data_ptr,
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash, \
-			    _calc_hash, _auth_decrypt) \
+			    _verify_hash_init, _verify_hash_update, \
+			    _verify_hash_final, _calc_hash, _auth_decrypt) \
 	const crypto_lib_desc_t crypto_lib_desc = { \
 		.name = _name, \
 		.init = _init, \
 		.verify_signature = _verify_signature, \
 		.verify_hash = _verify_hash, \
+		.verify_hash_init = _verify_hash_init, \
+		.verify_hash_update = _verify_hash_update, \
+		.verify_hash_final = _verify_hash_final, \
 		.calc_hash = _calc_hash, \
 		.auth_decrypt = _auth_decrypt \
 	}
 #elif CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash, \
-			    _auth_decrypt) \
+			    _verify_hash_init, _verify_hash_update, \
+			    _verify_hash_final, _auth_decrypt) \
 	const crypto_lib_desc_t crypto_lib_desc = { \
 		.name = _name, \
 		.init = _init, \
 		.verify_signature = _verify_signature, \
 		.verify_hash = _verify_hash, \
+		.verify_hash_init = _verify_hash_init, \
+		.verify_hash_update = _verify_hash_update, \
+		.verify_hash_final = _verify_hash_final, \
 		.auth_decrypt = _auth_decrypt \
 	}
 #elif CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY
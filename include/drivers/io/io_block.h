@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,8 @@
 #ifndef IO_BLOCK_H
 #define IO_BLOCK_H
 
+#include <stdbool.h>
+
 #include <drivers/io/io_storage.h>
 
 /* block devices ops */
@@ -15,10 +17,20 @@ typedef struct io_block_ops {
 	size_t	(*write)(int lba, const uintptr_t buf, size_t size);
 } io_block_ops_t;
 
+/*
+ * When direct is set, whole blocks are transferred straight to or from the
+ * caller's buffer, when it is block-aligned, instead of going through the
+ * underlying buffer. Only set it when the read and write ops can transfer data
+ * to or from any block-aligned buffer, not only to or from the underlying
+ * buffer. A direct transfer is at most direct_max_length bytes long, which must
+ * be a multiple of the block size.
+ */
 typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	bool		direct;
+	size_t		direct_max_length;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
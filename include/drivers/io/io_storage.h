@@ -80,6 +80,9 @@ int io_dev_open(const struct io_dev_connector *dev_con,
  * re-initialisation */
 int io_dev_init(uintptr_t dev_handle, const uintptr_t init_params);
 
+/* Return the type of an opened device */
+io_type_t io_dev_type(uintptr_t dev_handle);
+
 /* Close a connection to a device */
 int io_dev_close(uintptr_t dev_handle);
 
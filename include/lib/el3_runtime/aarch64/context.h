@@ -506,6 +506,7 @@ CASSERT(CTX_PAUTH_REGS_OFFSET == __builtin_offsetof(cpu_context_t, pauth_ctx), \
  * Function prototypes
  ******************************************************************************/
 void el1_sysregs_context_save(el1_sysregs_t *regs);
+void el1_sysregs_context_save_volatile(el1_sysregs_t *regs);
 void el1_sysregs_context_restore(el1_sysregs_t *regs);
 
 #if CTX_INCLUDE_EL2_REGS
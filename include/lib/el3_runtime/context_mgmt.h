@@ -40,9 +40,13 @@ void cm_prepare_el3_exit_ns(void);
 #if CTX_INCLUDE_EL2_REGS
 void cm_el2_sysregs_context_save(uint32_t security_state);
 void cm_el2_sysregs_context_restore(uint32_t security_state);
+#if CTX_EL2_REGS_LAZY_SWITCH
+void cm_el2_sysregs_context_switch(uint32_t src_state, uint32_t dst_state);
+#endif
 #endif
 
 void cm_el1_sysregs_context_save(uint32_t security_state);
+void cm_el1_sysregs_context_save_volatile(uint32_t security_state);
 void cm_el1_sysregs_context_restore(uint32_t security_state);
 void cm_set_elr_el3(uint32_t security_state, uintptr_t entrypoint);
 void cm_set_elr_spsr_el3(uint32_t security_state,
@@ -42,6 +42,9 @@ typedef struct pas_region {
 
 #define GPT_NSE_SHIFT                   U(62)
 
+/* Largest range transitioned by a single granule transition request (2MB) */
+#define GPT_MAX_TRANSITION_SIZE		(UL(1) << 21)
+
 /* PAS attribute GPI definitions. */
 #define GPT_PAS_ATTR_GPI_SHIFT		U(0)
 #define GPT_PAS_ATTR_GPI_MASK		U(0xF)
@@ -263,12 +266,15 @@ void gpt_disable(void);
  * transition request occurs it is routed to this function where the request is
  * validated then fulfilled if possible.
  *
- * TODO: implement support for transitioning multiple granules at once.
+ * A range of granules is transitioned as a whole. Its size is limited to
+ * GPT_MAX_TRANSITION_SIZE, so that the time spent holding the GPT lock stays
+ * bounded. Larger ranges must be split by the caller.
  *
  * Parameters
  *   base: Base address of the region to transition, must be aligned to granule
  *         size.
- *   size: Size of region to transition, must be aligned to granule size.
+ *   size: Size of region to transition, must be aligned to granule size and
+ *         not larger than GPT_MAX_TRANSITION_SIZE.
  *   src_sec_state: Security state of the originating SMC invoking the API.
  *
  * Return
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -40,7 +40,9 @@
  */
 #define PMF_SMC_GET_TIMESTAMP_32	U(0x82000010)
 #define PMF_SMC_GET_TIMESTAMP_64	U(0xC2000010)
-#define PMF_NUM_SMC_CALLS		2
+#define PMF_SMC_GET_TRACE_32		U(0x82000011)
+#define PMF_SMC_GET_TRACE_64		U(0xC2000011)
+#define PMF_NUM_SMC_CALLS		4
 
 /*
  * The macros below are used to identify
@@ -53,6 +55,7 @@
 /* Following are the supported PMF service IDs */
 #define PMF_PSCI_STAT_SVC_ID	0
 #define PMF_RT_INSTR_SVC_ID	1
+#define PMF_RT_TRACE_SVC_ID	2
 
 /*******************************************************************************
  * Function & variable prototypes
@@ -62,6 +65,12 @@ int pmf_get_timestamp_smc(unsigned int tid,
 		u_register_t mpidr,
 		unsigned int flags,
 		unsigned long long *ts_value);
+int pmf_get_trace_smc(unsigned int tid,
+		u_register_t mpidr,
+		unsigned long long buf_pa,
+		size_t buf_size,
+		unsigned int *count,
+		unsigned int *lost);
 int pmf_setup(void);
 uintptr_t pmf_smc_handler(unsigned int smc_fid,
 		u_register_t x1,
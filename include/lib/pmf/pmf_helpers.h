@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -11,6 +11,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <platform_def.h>
+
 #include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <plat/common/platform.h>
@@ -23,6 +25,41 @@ typedef unsigned long long (*pmf_svc_get_ts_t)(unsigned int tid,
 		 u_register_t mpidr,
 		 unsigned int flags);
 
+/*
+ * Number of records in each per-CPU trace ring. Must be a power of two.
+ */
+#ifdef PLAT_PMF_TRACE_RING_ENTRIES
+#define PMF_TRACE_RING_ENTRIES		PLAT_PMF_TRACE_RING_ENTRIES
+#else
+#define PMF_TRACE_RING_ENTRIES		U(64)
+#endif
+
+/*
+ * This is the definition of a record in a trace ring.
+ */
+typedef struct pmf_trace_rec {
+	/* Time-stamp at which the event occurred */
+	unsigned long long ts;
+
+	/* Local identifier of the event */
+	unsigned int tid;
+
+	/* Event specific data */
+	unsigned int payload;
+} pmf_trace_rec_t;
+
+/*
+ * This is the definition of the trace ring of a CPU. Only the owning CPU
+ * writes records into it, so it needs no locking. `head` is the number of
+ * records ever written and `tail` the number of records ever retrieved. When
+ * the ring is full, the oldest records are overwritten.
+ */
+typedef struct pmf_trace_ring {
+	volatile unsigned int head;
+	unsigned int tail;
+	pmf_trace_rec_t rec[PMF_TRACE_RING_ENTRIES];
+} __aligned(CACHE_WRITEBACK_GRANULE) pmf_trace_ring_t;
+
 /*
  * This is the definition of PMF service desc.
  */
@@ -41,6 +78,9 @@ typedef struct pmf_svc_desc {
 
 	/* PMF service time-stamp retrieval handler */
 	pmf_svc_get_ts_t get_ts;
+
+	/* Per-CPU trace rings of a trace service, NULL otherwise */
+	pmf_trace_ring_t *trace;
 } pmf_svc_desc_t;
 
 #if ENABLE_PMF
@@ -102,6 +142,23 @@ typedef struct pmf_svc_desc {
 #define PMF_GET_TIMESTAMP_BY_INDEX(_name, _tid, _cpuid, _flags, _tsval)\
 	_tsval = pmf_get_timestamp_by_index_ ## _name(_tid, _cpuid, _flags)
 
+/*
+ * Convenience macros for recording an event in a trace ring.
+ */
+#define PMF_DECLARE_TRACE(_name)					\
+	void pmf_trace_event_ ## _name(unsigned int tid,		\
+				unsigned int payload,			\
+				unsigned long long ts);
+
+#define PMF_TRACE_EVENT(_name, _tid, _payload)				\
+	pmf_trace_event_ ## _name((_tid), (_payload), read_cntpct_el0())
+
+#define PMF_WRITE_TRACE_EVENT(_name, _tid, _payload, _wrval)		\
+	do {								\
+		CASSERT(sizeof(_wrval) == sizeof(unsigned long long), invalid_wrval_size);\
+		pmf_trace_event_ ## _name((_tid), (_payload), (_wrval));\
+	} while (0)
+
 /* Convenience macros to register a PMF service.*/
 /*
  * This macro is used to register a PMF Service. It allocates PMF memory
@@ -122,6 +179,18 @@ typedef struct pmf_svc_desc {
 			_svcid, _totalid, NULL,			\
 			pmf_get_timestamp_by_mpidr_ ## _name)
 
+/*
+ * This macro is used to register a PMF trace service, including an SMC
+ * interface to retrieve the records. Instead of a single time-stamp per
+ * identifier, a trace service keeps the history of the last events recorded
+ * on each CPU, along with an event specific payload.
+ */
+#define PMF_REGISTER_TRACE_SERVICE_SMC(_name, _svcid, _totalid)	\
+	PMF_ALLOCATE_TRACE_MEMORY(_name)				\
+	PMF_DEFINE_TRACE_EVENT(_name, _totalid)				\
+	PMF_DEFINE_TRACE_SERVICE_DESC(_name, PMF_ARM_TIF_IMPL_ID,	\
+			_svcid, _totalid)
+
 /*
  * This macro is used to register a PMF service that has an SMC interface
  * but provides its own service-specific PMF functions.
@@ -137,11 +206,15 @@ typedef struct pmf_svc_desc {
 #define PMF_REGISTER_SERVICE_SMC(_name, _svcid, _totalid, _flags)
 #define PMF_REGISTER_SERVICE_SMC_OWN(_name, _implid, _svcid, _totalid,	\
 				_init, _getts)
+#define PMF_REGISTER_TRACE_SERVICE_SMC(_name, _svcid, _totalid)
 #define PMF_DECLARE_CAPTURE_TIMESTAMP(_name)
 #define PMF_DECLARE_GET_TIMESTAMP(_name)
+#define PMF_DECLARE_TRACE(_name)
 #define PMF_CAPTURE_TIMESTAMP(_name, _tid, _flags)
 #define PMF_GET_TIMESTAMP_BY_MPIDR(_name, _tid, _mpidr, _flags, _tsval)
 #define PMF_GET_TIMESTAMP_BY_INDEX(_name, _tid, _cpuid, _flags, _tsval)
+#define PMF_TRACE_EVENT(_name, _tid, _payload)
+#define PMF_WRITE_TRACE_EVENT(_name, _tid, _payload, _wrval)
 
 #endif /* ENABLE_PMF */
 
@@ -157,6 +230,15 @@ typedef struct pmf_svc_desc {
 	__section("pmf_timestamp_array")			\
 	__used;
 
+/*
+ * Convenience macro to allocate the per-CPU trace rings of a PMF service.
+ *
+ * The extern declaration is there to satisfy MISRA C-2012 rule 8.4.
+ */
+#define PMF_ALLOCATE_TRACE_MEMORY(_name)				\
+	extern pmf_trace_ring_t pmf_trace_mem_ ## _name[PLATFORM_CORE_COUNT];\
+	pmf_trace_ring_t pmf_trace_mem_ ## _name[PLATFORM_CORE_COUNT];
+
 /*
  * Convenience macro to validate tid index for the given TS array.
  */
@@ -218,6 +300,21 @@ typedef struct pmf_svc_desc {
 			plat_core_pos_by_mpidr(mpidr), flags);		\
 	}
 
+/*
+ * Convenience macro for recording an event in a trace ring.
+ *
+ * The extern declaration is there to satisfy MISRA C-2012 rule 8.4.
+ */
+#define PMF_DEFINE_TRACE_EVENT(_name, _totalid)				\
+	void pmf_trace_event_ ## _name(unsigned int tid,		\
+			unsigned int payload,				\
+			unsigned long long ts)				\
+	{								\
+		assert((tid & PMF_TID_MASK) < (_totalid));		\
+		__pmf_trace_record(pmf_trace_mem_ ## _name, tid,	\
+				payload, ts);				\
+	}
+
 /*
  * Convenience macro to register a PMF service.
  * This is needed for services that require SMC handling.
@@ -241,6 +338,26 @@ typedef struct pmf_svc_desc {
 		.get_ts = _getts_by_mpidr				\
 	};
 
+/*
+ * Convenience macro to register a PMF trace service.
+ */
+#define PMF_DEFINE_TRACE_SERVICE_DESC(_name, _implid, _svcid, _totalid)\
+	static const pmf_svc_desc_t __pmf_desc_ ## _name 		\
+	__section("pmf_svc_descs") __used = {		 		\
+		.h.type = PARAM_EP, 					\
+		.h.version = VERSION_1, 				\
+		.h.size = sizeof(pmf_svc_desc_t),			\
+		.h.attr = 0,						\
+		.name = #_name, 					\
+		.svc_config = ((((_implid) << PMF_IMPL_ID_SHIFT) &	\
+						PMF_IMPL_ID_MASK) |	\
+				(((_svcid) << PMF_SVC_ID_SHIFT) &	\
+						PMF_SVC_ID_MASK) |	\
+				(((_totalid) << PMF_TID_SHIFT) &	\
+						PMF_TID_MASK)),		\
+		.trace = pmf_trace_mem_ ## _name			\
+	};
+
 /* PMF internal functions */
 void __pmf_dump_timestamp(unsigned int tid, unsigned long long ts);
 void __pmf_store_timestamp(uintptr_t base_addr,
@@ -253,4 +370,8 @@ unsigned long long __pmf_get_timestamp(uintptr_t base_addr,
 		unsigned int tid,
 		unsigned int cpuid,
 		unsigned int flags);
+void __pmf_trace_record(pmf_trace_ring_t *rings,
+		unsigned int tid,
+		unsigned int payload,
+		unsigned long long ts);
 #endif /* PMF_HELPERS_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -59,6 +59,7 @@
 #define PSCI_NODE_HW_STATE_AARCH64	U(0xc400000d)
 #define PSCI_SYSTEM_SUSPEND_AARCH32	U(0x8400000E)
 #define PSCI_SYSTEM_SUSPEND_AARCH64	U(0xc400000E)
+#define PSCI_SET_SUSPEND_MODE		U(0x8400000F)
 #define PSCI_STAT_RESIDENCY_AARCH32	U(0x84000010)
 #define PSCI_STAT_RESIDENCY_AARCH64	U(0xc4000010)
 #define PSCI_STAT_COUNT_AARCH32		U(0x84000011)
@@ -72,8 +73,12 @@
 /*
  * Number of PSCI calls (above) implemented
  */
-#if ENABLE_PSCI_STAT
+#if ENABLE_PSCI_STAT && PSCI_OS_INIT_MODE
+#define PSCI_NUM_CALLS			U(23)
+#elif ENABLE_PSCI_STAT
 #define PSCI_NUM_CALLS			U(22)
+#elif PSCI_OS_INIT_MODE
+#define PSCI_NUM_CALLS			U(19)
 #else
 #define PSCI_NUM_CALLS			U(18)
 #endif
@@ -136,6 +141,12 @@
 #define FF_MODE_SUPPORT_SHIFT		U(0)
 #define FF_SUPPORTS_OS_INIT_MODE	U(1)
 
+/*******************************************************************************
+ * PSCI_SET_SUSPEND_MODE 'mode' parameter values
+ ******************************************************************************/
+#define PSCI_MODE_PLAT_COORD	U(0)
+#define PSCI_MODE_OS_INIT	U(1)
+
 /*******************************************************************************
  * PSCI version
  ******************************************************************************/
@@ -347,6 +358,9 @@ u_register_t psci_migrate_info_up_cpu(void);
 int psci_node_hw_state(u_register_t target_cpu,
 		       unsigned int power_level);
 int psci_features(unsigned int psci_fid);
+#if PSCI_OS_INIT_MODE
+int psci_set_suspend_mode(unsigned int mode);
+#endif
 void __dead2 psci_power_down_wfi(void);
 void psci_arch_setup(void);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -15,11 +15,16 @@
 #define RT_INSTR_EXIT_HW_LOW_PWR	U(3)
 #define RT_INSTR_ENTER_CFLUSH		U(4)
 #define RT_INSTR_EXIT_CFLUSH		U(5)
-#define RT_INSTR_TOTAL_IDS		U(6)
+#define RT_INSTR_ENTER_FFA_DIRECT_REQ	U(6)
+#define RT_INSTR_EXIT_FFA_DIRECT_RESP	U(7)
+#define RT_INSTR_ENTER_WORLD_SWITCH	U(8)
+#define RT_INSTR_EXIT_WORLD_SWITCH	U(9)
+#define RT_INSTR_TOTAL_IDS		U(10)
 
 #ifndef __ASSEMBLER__
 PMF_DECLARE_CAPTURE_TIMESTAMP(rt_instr_svc)
 PMF_DECLARE_GET_TIMESTAMP(rt_instr_svc)
+PMF_DECLARE_TRACE(rt_trace_svc)
 #endif /* __ASSEMBLER__ */
 
 #endif /* RUNTIME_INSTR_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -15,9 +15,21 @@ typedef struct spinlock {
 	volatile uint32_t lock;
 } spinlock_t;
 
+/*
+ * Ticket lock, granted to the CPUs in the order they asked for it. Bits [31:16]
+ * hold the next ticket to be handed out and bits [15:0] the ticket being
+ * served. Like spinlocks, it requires all the CPUs taking it to be coherent.
+ */
+typedef struct ticket_lock {
+	volatile uint32_t lock;
+} ticket_lock_t;
+
 void spin_lock(spinlock_t *lock);
 void spin_unlock(spinlock_t *lock);
 
+void ticket_lock(ticket_lock_t *lock);
+void ticket_unlock(ticket_lock_t *lock);
+
 #else
 
 /* Spin lock definitions for use in assembly */
@@ -108,6 +108,13 @@
 #define XLAT_BLOCK_MASK(level)	(XLAT_BLOCK_SIZE(level) - UL(1))
 /* Mask to get the address bits common to a block of a certain table level*/
 #define XLAT_ADDR_MASK(level)	(~XLAT_BLOCK_MASK(level))
+
+/*
+ * Number of adjacent entries that must have the Contiguous hint set for the TLB
+ * to cache them as a single entry. The run must be aligned to its size in both
+ * VA and PA. With a 4KB granule it is the same at all levels.
+ */
+#define XLAT_CONT_ENTRIES	U(16)
 /*
  * Extract from the given virtual address the index into the given lookup level.
  * This macro assumes the system is using the 4KB translation granule.
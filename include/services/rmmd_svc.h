@@ -128,6 +128,22 @@
 					/* 0x1B3 */
 #define RMM_ATTEST_GET_PLAT_TOKEN	SMC64_RMMD_EL3_FID(U(3))
 
+/*
+ * Delegate or undelegate a range of granules. The arguments to these SMCs are :
+ *    arg0 - Function ID.
+ *    arg1 - Physical address of the start of the range.
+ *    arg2 - Size of the range (in bytes).
+ * The return arguments are :
+ *    ret0 - Status / error.
+ *    ret1 - Size of the part of the range that was transitioned (in bytes).
+ *
+ * At most GPT_MAX_TRANSITION_SIZE bytes are transitioned per call. The caller
+ * issues the SMC again for the rest of the range, starting at arg1 + ret1.
+ */
+					/* 0x1B4 - 0x1B5 */
+#define RMM_GTSI_DELEGATE_RANGE		SMC64_RMMD_EL3_FID(U(4))
+#define RMM_GTSI_UNDELEGATE_RANGE	SMC64_RMMD_EL3_FID(U(5))
+
 /* ECC Curve types for attest key generation */
 #define ATTEST_KEY_CURVE_ECC_SECP384R1		0
 
@@ -152,7 +168,7 @@
  * Increase this when a bug is fixed, or a feature is added without
  * breaking compatibility.
  */
-#define RMM_EL3_IFC_VERSION_MINOR	(U(1))
+#define RMM_EL3_IFC_VERSION_MINOR	(U(2))
 
 #define RMM_EL3_INTERFACE_VERSION				\
 	(((RMM_EL3_IFC_VERSION_MAJOR << 16) & 0x7FFFF) |	\
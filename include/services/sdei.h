@@ -74,8 +74,17 @@
 	SDEI_EVENT_MAP((_event), 0, (_pri) | SDEI_MAPF_EXPLICIT | SDEI_MAPF_PRIVATE)
 
 /*
- * Declare shared and private entries for each core. Also declare a global
- * structure containing private and share entries.
+ * Number of slots of the tables indexing the mappings by event number and by
+ * interrupt. The tables are kept less than half full so that lookups only need
+ * a few probes.
+ */
+#define SDEI_INDEX_SLOTS(_private, _shared) \
+	((2U * (ARRAY_SIZE(_private) + ARRAY_SIZE(_shared))) + 1U)
+
+/*
+ * Declare shared and private entries for each core, and the tables indexing
+ * the mappings. Also declare a global structure containing private and share
+ * entries.
  *
  * This macro must be used in the same file as the platform SDEI mappings are
  * declared. Only then would ARRAY_SIZE() yield a meaningful value.
@@ -84,6 +93,15 @@
 	sdei_entry_t sdei_private_event_table \
 		[PLATFORM_CORE_COUNT * ARRAY_SIZE(_private)]; \
 	sdei_entry_t sdei_shared_event_table[ARRAY_SIZE(_shared)]; \
+	static sdei_ev_map_t *sdei_ev_index_slots \
+		[SDEI_INDEX_SLOTS(_private, _shared)]; \
+	static sdei_ev_map_t *sdei_intr_index_slots \
+		[SDEI_INDEX_SLOTS(_private, _shared)]; \
+	const sdei_index_t sdei_global_index = { \
+		.ev_slots = sdei_ev_index_slots, \
+		.intr_slots = sdei_intr_index_slots, \
+		.num_slots = SDEI_INDEX_SLOTS(_private, _shared) \
+	}; \
 	const sdei_mapping_t sdei_global_mappings[] = { \
 		[SDEI_MAP_IDX_PRIV_] = { \
 			.map = (_private), \
@@ -122,6 +140,16 @@ typedef struct sdei_mapping {
 	size_t num_maps;
 } sdei_mapping_t;
 
+/*
+ * Open addressing hash tables of pointers to the mappings, indexed by event
+ * number and by bound interrupt.
+ */
+typedef struct sdei_index {
+	sdei_ev_map_t **ev_slots;
+	sdei_ev_map_t **intr_slots;
+	size_t num_slots;
+} sdei_index_t;
+
 /* Handler to be called to handle SDEI smc calls */
 uint64_t sdei_smc_handler(uint32_t smc_fid,
 		uint64_t x1,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -29,7 +29,7 @@
 #define SPM_MM_VERSION_MAJOR		  U(0)
 #define SPM_MM_VERSION_MAJOR_SHIFT	  16
 #define SPM_MM_VERSION_MAJOR_MASK	  U(0x7FFF)
-#define SPM_MM_VERSION_MINOR		  U(1)
+#define SPM_MM_VERSION_MINOR		  U(2)
 #define SPM_MM_VERSION_MINOR_SHIFT	  0
 #define SPM_MM_VERSION_MINOR_MASK	  U(0xFFFF)
 #define SPM_MM_VERSION_FORM(major, minor) ((major << \
@@ -65,6 +65,7 @@
 #define MM_SP_EVENT_COMPLETE_AARCH64		U(0xC4000061)
 #define MM_SP_MEMORY_ATTRIBUTES_GET_AARCH64	U(0xC4000064)
 #define MM_SP_MEMORY_ATTRIBUTES_SET_AARCH64	U(0xC4000065)
+#define MM_SP_SECONDARY_EP_REGISTER_AARCH64	U(0xC4000066)
 
 /*
  * Macros used by MM_SP_MEMORY_ATTRIBUTES_SET_AARCH64.
@@ -35,6 +35,13 @@ uint64_t spmd_smc_switch_state(uint32_t smc_fid,
 			       uint64_t x3,
 			       uint64_t x4,
 			       void *handle);
+uint64_t spmd_smc_switch_state_volatile_el1(uint32_t smc_fid,
+					    bool secure_origin,
+					    uint64_t x1,
+					    uint64_t x2,
+					    uint64_t x3,
+					    uint64_t x4,
+					    void *handle);
 #endif /* __ASSEMBLER__ */
 
 #endif /* SPMD_SVC_H */
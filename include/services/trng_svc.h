@@ -37,6 +37,9 @@
 /* Public API to perform the initial TRNG entropy setup */
 void trng_setup(void);
 
+/* Public API to top up the entropy pool of the calling CPU */
+void trng_entropy_pool_refill(void);
+
 /* Public API to verify function id is part of TRNG */
 bool is_trng_fid(uint32_t smc_fid);
 
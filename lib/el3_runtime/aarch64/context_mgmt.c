@@ -907,6 +907,160 @@ void cm_el2_sysregs_context_restore(uint32_t security_state)
 #endif
 	}
 }
+
+#if CTX_EL2_REGS_LAZY_SWITCH
+/*******************************************************************************
+ * Helper to check whether a group of EL2 registers, from the register at offset
+ * 'first' to the register at offset 'last', holds different values in two EL2
+ * sysreg contexts.
+ ******************************************************************************/
+static bool el2_sysregs_differ(el2_sysregs_t *src, el2_sysregs_t *dst,
+			       unsigned int first, unsigned int last)
+{
+	for (unsigned int off = first; off <= last; off += U(8)) {
+		if (read_ctx_reg(src, off) != read_ctx_reg(dst, off)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*******************************************************************************
+ * Switch the EL2 sysreg context from one security state to another. This is
+ * equivalent to cm_el2_sysregs_context_save(src_state) followed by
+ * cm_el2_sysregs_context_restore(dst_state), except that:
+ *
+ * - A group of registers guarded by an SCR_EL3 enable bit is only saved if the
+ *   bit is set for the source security state. Otherwise, its accesses from EL2
+ *   trap to EL3 so the registers still hold the values restored from the
+ *   source context.
+ *
+ * - The MPAM, FGT, VHE and RAS groups are only restored if the destination
+ *   context holds different values than the ones just saved, i.e. than the ones
+ *   currently held by the registers. The other groups hold a single register,
+ *   which is cheaper to restore than to compare, so they are always restored.
+ *
+ * This relies on the registers of these groups being only written by context
+ * restores while in EL3.
+ ******************************************************************************/
+void cm_el2_sysregs_context_switch(uint32_t src_state, uint32_t dst_state)
+{
+	u_register_t scr_el3 = read_scr();
+	u_register_t src_scr_el3;
+	cpu_context_t *src_ctx, *dst_ctx;
+	el2_sysregs_t *src, *dst;
+
+	/*
+	 * Fall back to a full save and restore if the S-EL2 context is not in
+	 * use on either side of the switch.
+	 */
+	if (((src_state == SECURE) || (dst_state == SECURE)) &&
+	    ((scr_el3 & SCR_EEL2_BIT) == 0U)) {
+		cm_el2_sysregs_context_save(src_state);
+		cm_el2_sysregs_context_restore(dst_state);
+		return;
+	}
+
+	src_ctx = cm_get_context(src_state);
+	dst_ctx = cm_get_context(dst_state);
+	assert((src_ctx != NULL) && (dst_ctx != NULL));
+
+	src = get_el2_sysregs_ctx(src_ctx);
+	dst = get_el2_sysregs_ctx(dst_ctx);
+	src_scr_el3 = read_ctx_reg(get_el3state_ctx(src_ctx), CTX_SCR_EL3);
+
+	/* Save the groups the source security state was able to modify. */
+	el2_sysregs_context_save_common(src);
+#if ENABLE_SPE_FOR_LOWER_ELS
+	el2_sysregs_context_save_spe(src);
+#endif
+#if CTX_INCLUDE_MTE_REGS
+	if ((src_scr_el3 & SCR_ATA_BIT) != 0U) {
+		el2_sysregs_context_save_mte(src);
+	}
+#endif
+#if ENABLE_MPAM_FOR_LOWER_ELS
+	el2_sysregs_context_save_mpam(src);
+#endif
+#if ENABLE_FEAT_FGT
+	if ((src_scr_el3 & SCR_FGTEN_BIT) != 0U) {
+		el2_sysregs_context_save_fgt(src);
+	}
+#endif
+#if ENABLE_FEAT_ECV
+	if ((src_scr_el3 & SCR_ECVEN_BIT) != 0U) {
+		el2_sysregs_context_save_ecv(src);
+	}
+#endif
+#if ENABLE_FEAT_VHE
+	el2_sysregs_context_save_vhe(src);
+#endif
+#if RAS_EXTENSION
+	el2_sysregs_context_save_ras(src);
+#endif
+#if CTX_INCLUDE_NEVE_REGS
+	el2_sysregs_context_save_nv2(src);
+#endif
+#if ENABLE_TRF_FOR_NS
+	el2_sysregs_context_save_trf(src);
+#endif
+#if ENABLE_FEAT_CSV2_2
+	if ((src_scr_el3 & SCR_EnSCXT_BIT) != 0U) {
+		el2_sysregs_context_save_csv2(src);
+	}
+#endif
+#if ENABLE_FEAT_HCX
+	if ((src_scr_el3 & SCR_HXEn_BIT) != 0U) {
+		el2_sysregs_context_save_hcx(src);
+	}
+#endif
+
+	/* Restore the groups, skipping the larger ones that did not change. */
+	el2_sysregs_context_restore_common(dst);
+#if ENABLE_SPE_FOR_LOWER_ELS
+	el2_sysregs_context_restore_spe(dst);
+#endif
+#if CTX_INCLUDE_MTE_REGS
+	el2_sysregs_context_restore_mte(dst);
+#endif
+#if ENABLE_MPAM_FOR_LOWER_ELS
+	if (el2_sysregs_differ(src, dst, CTX_MPAM2_EL2, CTX_MPAMVPMV_EL2)) {
+		el2_sysregs_context_restore_mpam(dst);
+	}
+#endif
+#if ENABLE_FEAT_FGT
+	if (el2_sysregs_differ(src, dst, CTX_HDFGRTR_EL2, CTX_HFGWTR_EL2)) {
+		el2_sysregs_context_restore_fgt(dst);
+	}
+#endif
+#if ENABLE_FEAT_ECV
+	el2_sysregs_context_restore_ecv(dst);
+#endif
+#if ENABLE_FEAT_VHE
+	if (el2_sysregs_differ(src, dst, CTX_CONTEXTIDR_EL2, CTX_TTBR1_EL2)) {
+		el2_sysregs_context_restore_vhe(dst);
+	}
+#endif
+#if RAS_EXTENSION
+	if (el2_sysregs_differ(src, dst, CTX_VDISR_EL2, CTX_VSESR_EL2)) {
+		el2_sysregs_context_restore_ras(dst);
+	}
+#endif
+#if CTX_INCLUDE_NEVE_REGS
+	el2_sysregs_context_restore_nv2(dst);
+#endif
+#if ENABLE_TRF_FOR_NS
+	el2_sysregs_context_restore_trf(dst);
+#endif
+#if ENABLE_FEAT_CSV2_2
+	el2_sysregs_context_restore_csv2(dst);
+#endif
+#if ENABLE_FEAT_HCX
+	el2_sysregs_context_restore_hcx(dst);
+#endif
+}
+#endif /* CTX_EL2_REGS_LAZY_SWITCH */
 #endif /* CTX_INCLUDE_EL2_REGS */
 
 /*******************************************************************************
@@ -979,6 +1133,28 @@ void cm_el1_sysregs_context_save(uint32_t security_state)
 #endif
 }
 
+/*******************************************************************************
+ * Save the volatile part of the EL1 system register context of the given
+ * security state, leaving the registers configuring its translation regime and
+ * exception vectors as they were last saved.
+ ******************************************************************************/
+void cm_el1_sysregs_context_save_volatile(uint32_t security_state)
+{
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx != NULL);
+
+	el1_sysregs_context_save_volatile(get_el1_sysregs_ctx(ctx));
+
+#if IMAGE_BL31
+	if (security_state == SECURE)
+		PUBLISH_EVENT(cm_exited_secure_world);
+	else
+		PUBLISH_EVENT(cm_exited_normal_world);
+#endif
+}
+
 void cm_el1_sysregs_context_restore(uint32_t security_state)
 {
 	cpu_context_t *ctx;
@@ -961,16 +961,45 @@ int gpt_runtime_init(void)
 static spinlock_t gpt_lock;
 
 /*
- * A helper to write the value (target_pas << gpi_shift) to the index of
- * the gpt_l1_addr
+ * Block sizes that a single TLBI RPALOS instruction can invalidate, indexed by
+ * the value of its SIZE field.
  */
-static inline void write_gpt(uint64_t *gpt_l1_desc, uint64_t *gpt_l1_addr,
-			     unsigned int gpi_shift, unsigned int idx,
-			     unsigned int target_pas)
+static const uint64_t gpt_tlbi_rpa_sizes[] = {
+	0x1000ULL,		/* 4KB */
+	0x4000ULL,		/* 16KB */
+	0x10000ULL,		/* 64KB */
+	0x200000ULL,		/* 2MB */
+	0x2000000ULL,		/* 32MB */
+	0x20000000ULL,		/* 512MB */
+	0x40000000ULL,		/* 1GB */
+	0x400000000ULL,		/* 16GB */
+	0x1000000000ULL,	/* 64GB */
+	0x8000000000ULL		/* 512GB */
+};
+
+/*
+ * Invalidate the TLB entries of the GPT information for a range of PAs. The
+ * range is covered with as few TLBI RPALOS instructions as its alignment
+ * allows. The caller completes them with a single barrier.
+ */
+static void gpt_tlbi_by_pa_range(uint64_t base, size_t size)
 {
-	*gpt_l1_desc &= ~(GPT_L1_GRAN_DESC_GPI_MASK << gpi_shift);
-	*gpt_l1_desc |= ((uint64_t)target_pas << gpi_shift);
-	gpt_l1_addr[idx] = *gpt_l1_desc;
+	uint64_t end = base + size;
+	unsigned int i;
+
+	while (base < end) {
+		/* Find the largest block aligned on 'base' and within range */
+		for (i = ARRAY_SIZE(gpt_tlbi_rpa_sizes) - 1U; i > 0U; i--) {
+			if (((base & (gpt_tlbi_rpa_sizes[i] - 1U)) == 0ULL) &&
+			    ((end - base) >= gpt_tlbi_rpa_sizes[i])) {
+				break;
+			}
+		}
+
+		tlbirpalos(TLBI_ADDR(base) |
+			   ((uint64_t)i << TLBI_RPA_SIZE_SHIFT));
+		base += gpt_tlbi_rpa_sizes[i];
+	}
 }
 
 /*
@@ -1000,18 +1029,117 @@ static int get_gpi_params(uint64_t base, gpi_info_t *gpi_info)
 	return 0;
 }
 
+/*
+ * Helper to check that all the granules of a range are covered by L1 tables
+ * and in the 'expected_gpi' state. On failure, the GPI of the offending granule
+ * is returned in 'gpi'. This is done before changing anything, so that a range
+ * transition either fully happens or not at all.
+ */
+static int check_range_gpi(uint64_t base, size_t size,
+			   unsigned int expected_gpi, unsigned int *gpi)
+{
+	gpi_info_t gpi_info;
+	uint64_t pa;
+	int res;
+
+	for (pa = base; pa < (base + size);
+	     pa += GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
+		res = get_gpi_params(pa, &gpi_info);
+		if (res != 0) {
+			return res;
+		}
+
+		*gpi = gpi_info.gpi;
+		if (gpi_info.gpi != expected_gpi) {
+			VERBOSE("[GPT] Granule 0x%" PRIx64 " in GPI 0x%x\n",
+				pa, gpi_info.gpi);
+			return -EPERM;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Helper to set the GPI of all the granules of a range, which must have been
+ * checked with check_range_gpi(). Each L1 descriptor is written once with the
+ * new GPI of all the granules it covers within the range.
+ */
+static void write_range_gpi(uint64_t base, size_t size,
+			    unsigned int target_pas)
+{
+	gpi_info_t gpi_info;
+	uint64_t *gpt_l1_addr = NULL;
+	uint64_t gpt_l1_desc = 0ULL;
+	unsigned int idx = 0U;
+	uint64_t pa;
+
+	for (pa = base; pa < (base + size);
+	     pa += GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
+		(void)get_gpi_params(pa, &gpi_info);
+
+		if ((gpi_info.gpt_l1_addr != gpt_l1_addr) ||
+		    (gpi_info.idx != idx)) {
+			/* Flush the descriptor of the previous granules */
+			if (gpt_l1_addr != NULL) {
+				gpt_l1_addr[idx] = gpt_l1_desc;
+			}
+			gpt_l1_addr = gpi_info.gpt_l1_addr;
+			idx = gpi_info.idx;
+			gpt_l1_desc = gpi_info.gpt_l1_desc;
+		}
+
+		gpt_l1_desc &= ~(GPT_L1_GRAN_DESC_GPI_MASK <<
+				 gpi_info.gpi_shift);
+		gpt_l1_desc |= ((uint64_t)target_pas << gpi_info.gpi_shift);
+	}
+
+	if (gpt_l1_addr != NULL) {
+		gpt_l1_addr[idx] = gpt_l1_desc;
+	}
+}
+
+/*
+ * Helper to validate the base and size of a range of granules to transition.
+ */
+static int check_transition_range(uint64_t base, size_t size)
+{
+	/* Check that base and size are valid */
+	if ((ULONG_MAX - base) < size) {
+		VERBOSE("[GPT] Transition request address overflow!\n");
+		VERBOSE("      Base=0x%" PRIx64 "\n", base);
+		VERBOSE("      Size=0x%lx\n", size);
+		return -EINVAL;
+	}
+
+	/* Make sure base and size are valid. */
+	if (((base & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
+	    ((size & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
+	    (size == 0UL) || (size > GPT_MAX_TRANSITION_SIZE) ||
+	    ((base + size) >= GPT_PPS_ACTUAL_SIZE(gpt_config.t))) {
+		VERBOSE("[GPT] Invalid granule transition address range!\n");
+		VERBOSE("      Base=0x%" PRIx64 "\n", base);
+		VERBOSE("      Size=0x%lx\n", size);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 /*
  * This function is the granule transition delegate service. When a granule
  * transition request occurs it is routed to this function to have the request,
  * if valid, fulfilled following A1.1.1 Delegate of RME supplement
  *
- * TODO: implement support for transitioning multiple granules at once.
+ * A range of granules is transitioned as a whole under a single lock, with one
+ * cache maintenance pass and one range TLB invalidation. If any granule of the
+ * range is not in the NS state, none of them are transitioned.
  *
  * Parameters
  *   base		Base address of the region to transition, must be
  *			aligned to granule size.
  *   size		Size of region to transition, must be aligned to granule
- *			size.
+ *			size and not larger than GPT_MAX_TRANSITION_SIZE.
  *   src_sec_state	Security state of the caller.
  *
  * Return
@@ -1019,9 +1147,9 @@ static int get_gpi_params(uint64_t base, gpi_info_t *gpi_info)
  */
 int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 {
-	gpi_info_t gpi_info;
 	uint64_t nse;
 	int res;
+	unsigned int gpi;
 	unsigned int target_pas;
 
 	/* Ensure that the tables have been set up before taking requests. */
@@ -1034,28 +1162,9 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	assert(src_sec_state == SMC_FROM_REALM ||
 	       src_sec_state == SMC_FROM_SECURE);
 
-	/* See if this is a single or a range of granule transition. */
-	if (size != GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
-		return -EINVAL;
-	}
-
-	/* Check that base and size are valid */
-	if ((ULONG_MAX - base) < size) {
-		VERBOSE("[GPT] Transition request address overflow!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
-	}
-
-	/* Make sure base and size are valid. */
-	if (((base & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    ((size & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    (size == 0UL) ||
-	    ((base + size) >= GPT_PPS_ACTUAL_SIZE(gpt_config.t))) {
-		VERBOSE("[GPT] Invalid granule transition address range!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
+	res = check_transition_range(base, size);
+	if (res != 0) {
+		return res;
 	}
 
 	target_pas = GPT_GPI_REALM;
@@ -1069,21 +1178,19 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 * given time.
 	 */
 	spin_lock(&gpt_lock);
-	res = get_gpi_params(base, &gpi_info);
+
+	/* Check that the whole range is in NS state */
+	res = check_range_gpi(base, size, GPT_GPI_NS, &gpi);
 	if (res != 0) {
+		if (res == -EPERM) {
+			VERBOSE("[GPT] Only Granule in NS state can be delegated.\n");
+			VERBOSE("      Caller: %u, Current GPI: %u\n",
+				src_sec_state, gpi);
+		}
 		spin_unlock(&gpt_lock);
 		return res;
 	}
 
-	/* Check that the current address is in NS state */
-	if (gpi_info.gpi != GPT_GPI_NS) {
-		VERBOSE("[GPT] Only Granule in NS state can be delegated.\n");
-		VERBOSE("      Caller: %u, Current GPI: %u\n", src_sec_state,
-			gpi_info.gpi);
-		spin_unlock(&gpt_lock);
-		return -EPERM;
-	}
-
 	if (src_sec_state == SMC_FROM_SECURE) {
 		nse = (uint64_t)GPT_NSE_SECURE << GPT_NSE_SHIFT;
 	} else {
@@ -1095,20 +1202,17 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 * states, remove any data speculatively fetched into the target
 	 * physical address space. Issue DC CIPAPA over address range
 	 */
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, target_pas);
+	write_range_gpi(base, size, target_pas);
 	dsboshst();
 
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_by_pa_range(base, size);
 	dsbosh();
 
 	nse = (uint64_t)GPT_NSE_NS << GPT_NSE_SHIFT;
 
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
 	/* Unlock access to the L1 tables. */
 	spin_unlock(&gpt_lock);
@@ -1117,8 +1221,8 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 * The isb() will be done as part of context
 	 * synchronization when returning to lower EL
 	 */
-	VERBOSE("[GPT] Granule 0x%" PRIx64 ", GPI 0x%x->0x%x\n",
-		base, gpi_info.gpi, target_pas);
+	VERBOSE("[GPT] Granules 0x%" PRIx64 "-0x%" PRIx64 ", GPI 0x%x->0x%x\n",
+		base, base + size - 1U, gpi, target_pas);
 
 	return 0;
 }
@@ -1128,13 +1232,14 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
  * transition request occurs it is routed to this function where the request is
  * validated then fulfilled if possible.
  *
- * TODO: implement support for transitioning multiple granules at once.
+ * As for delegation, a range of granules is transitioned as a whole, only if
+ * all of them are in the state delegated to the caller.
  *
  * Parameters
  *   base		Base address of the region to transition, must be
  *			aligned to granule size.
  *   size		Size of region to transition, must be aligned to granule
- *			size.
+ *			size and not larger than GPT_MAX_TRANSITION_SIZE.
  *   src_sec_state	Security state of the caller.
  *
  * Return
@@ -1142,9 +1247,10 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
  */
 int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 {
-	gpi_info_t gpi_info;
 	uint64_t nse;
 	int res;
+	unsigned int gpi;
+	unsigned int src_pas;
 
 	/* Ensure that the tables have been set up before taking requests. */
 	assert(gpt_config.plat_gpt_l0_base != 0UL);
@@ -1156,28 +1262,14 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	assert(src_sec_state == SMC_FROM_REALM ||
 	       src_sec_state == SMC_FROM_SECURE);
 
-	/* See if this is a single or a range of granule transition. */
-	if (size != GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
-		return -EINVAL;
-	}
-
-	/* Check that base and size are valid */
-	if ((ULONG_MAX - base) < size) {
-		VERBOSE("[GPT] Transition request address overflow!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
+	res = check_transition_range(base, size);
+	if (res != 0) {
+		return res;
 	}
 
-	/* Make sure base and size are valid. */
-	if (((base & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    ((size & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    (size == 0UL) ||
-	    ((base + size) >= GPT_PPS_ACTUAL_SIZE(gpt_config.t))) {
-		VERBOSE("[GPT] Invalid granule transition address range!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
+	src_pas = GPT_GPI_REALM;
+	if (src_sec_state == SMC_FROM_SECURE) {
+		src_pas = GPT_GPI_SECURE;
 	}
 
 	/*
@@ -1187,35 +1279,28 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 */
 	spin_lock(&gpt_lock);
 
-	res = get_gpi_params(base, &gpi_info);
+	/* Check that the whole range is in the delegated state */
+	res = check_range_gpi(base, size, src_pas, &gpi);
 	if (res != 0) {
+		if (res == -EPERM) {
+			VERBOSE("[GPT] Only Granule in REALM or SECURE state can be undelegated.\n");
+			VERBOSE("      Caller: %u, Current GPI: %u\n",
+				src_sec_state, gpi);
+		}
 		spin_unlock(&gpt_lock);
 		return res;
 	}
 
-	/* Check that the current address is in the delegated state */
-	if ((src_sec_state == SMC_FROM_REALM  &&
-	     gpi_info.gpi != GPT_GPI_REALM) ||
-	    (src_sec_state == SMC_FROM_SECURE &&
-	     gpi_info.gpi != GPT_GPI_SECURE)) {
-		VERBOSE("[GPT] Only Granule in REALM or SECURE state can be undelegated.\n");
-		VERBOSE("      Caller: %u, Current GPI: %u\n", src_sec_state,
-			gpi_info.gpi);
-		spin_unlock(&gpt_lock);
-		return -EPERM;
-	}
-
 
 	/* In order to maintain mutual distrust between Realm and Secure
 	 * states, remove access now, in order to guarantee that writes
 	 * to the currently-accessible physical address space will not
 	 * later become observable.
 	 */
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, GPT_GPI_NO_ACCESS);
+	write_range_gpi(base, size, GPT_GPI_NO_ACCESS);
 	dsboshst();
 
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_by_pa_range(base, size);
 	dsbosh();
 
 	if (src_sec_state == SMC_FROM_SECURE) {
@@ -1225,8 +1310,7 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	}
 
 	/* Ensure that the scrubbed data has made it past the PoPA */
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
 	/*
 	 * Remove any data loaded speculatively
@@ -1234,16 +1318,14 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 */
 	nse = (uint64_t)GPT_NSE_NS << GPT_NSE_SHIFT;
 
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
-	/* Clear existing GPI encoding and transition granule. */
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, GPT_GPI_NS);
+	/* Clear existing GPI encoding and transition granules. */
+	write_range_gpi(base, size, GPT_GPI_NS);
 	dsboshst();
 
 	/* Ensure that all agents observe the new NS configuration */
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_by_pa_range(base, size);
 	dsbosh();
 
 	/* Unlock access to the L1 tables. */
@@ -1253,8 +1335,8 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 * The isb() will be done as part of context
 	 * synchronization when returning to lower EL
 	 */
-	VERBOSE("[GPT] Granule 0x%" PRIx64 ", GPI 0x%x->0x%x\n",
-		base, gpi_info.gpi, GPT_GPI_NS);
+	VERBOSE("[GPT] Granules 0x%" PRIx64 "-0x%" PRIx64 ", GPI 0x%x->0x%x\n",
+		base, base + size - 1U, gpi, GPT_GPI_NS);
 
 	return 0;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -12,7 +12,11 @@
 #include <arch_helpers.h>
 #include <common/debug.h>
 #include <lib/pmf/pmf.h>
+#include <lib/spinlock.h>
 #include <lib/utils_def.h>
+#if PLAT_XLAT_TABLES_DYNAMIC
+#include <lib/xlat_tables/xlat_tables_v2.h>
+#endif
 #include <plat/common/platform.h>
 
 /*******************************************************************************
@@ -34,6 +38,9 @@ IMPORT_SYM(uintptr_t,  __PMF_TIMESTAMP_START__,		PMF_TIMESTAMP_ARRAY_START);
 
 #define PMF_SVC_DESCS_MAX		10
 
+CASSERT((PMF_TRACE_RING_ENTRIES & (PMF_TRACE_RING_ENTRIES - 1U)) == 0U,
+	assert_pmf_trace_ring_entries_not_power_of_two);
+
 /*
  * This is used to traverse through registered PMF services.
  */
@@ -69,7 +76,8 @@ int pmf_setup(void)
 	pmf_svc_descs = (pmf_svc_desc_t *) PMF_SVC_DESCS_START;
 	for (ii = 0; ii < pmf_svc_descs_num; ii++) {
 
-		assert(pmf_svc_descs[ii].get_ts != NULL);
+		assert((pmf_svc_descs[ii].get_ts != NULL) ||
+		       (pmf_svc_descs[ii].trace != NULL));
 
 		/*
 		 * Call the initialization routine for this
@@ -165,7 +173,8 @@ int pmf_get_timestamp_smc(unsigned int tid,
 	/* Search for registered service. */
 	svc_desc = get_service(tid);
 
-	if ((svc_desc == NULL) || (plat_core_pos_by_mpidr(mpidr) < 0)) {
+	if ((svc_desc == NULL) || (svc_desc->get_ts == NULL) ||
+	    (plat_core_pos_by_mpidr(mpidr) < 0)) {
 		*ts_value = 0;
 		return -EINVAL;
 	} else {
@@ -175,6 +184,160 @@ int pmf_get_timestamp_smc(unsigned int tid,
 	}
 }
 
+/*
+ * This lock serialises the retrieval of trace records, including the mapping
+ * of the buffer they are retrieved in, as the dynamic regions of the
+ * translation tables cannot be updated concurrently. Recording them needs no
+ * lock as only the owning CPU writes into its trace ring.
+ */
+static spinlock_t pmf_trace_lock;
+
+/*
+ * This function moves the trace records of the CPU identified by `mpidr` not
+ * retrieved yet, oldest first, into the buffer `buf` of `buf_size` bytes. It
+ * returns in `count` the number of records moved and in `lost` the number of
+ * records overwritten before they could be retrieved. It must be called with
+ * `pmf_trace_lock` held.
+ */
+static int pmf_drain_trace(pmf_trace_ring_t *ring, pmf_trace_rec_t *buf,
+		size_t buf_size, unsigned int *count, unsigned int *lost)
+{
+	unsigned int head, tail, n, torn, i;
+
+	/* Make sure the records are read after the head */
+	head = ring->head;
+	dmbish();
+
+	tail = ring->tail;
+	*lost = 0U;
+	if ((head - tail) > PMF_TRACE_RING_ENTRIES) {
+		*lost = head - tail - PMF_TRACE_RING_ENTRIES;
+		tail = head - PMF_TRACE_RING_ENTRIES;
+	}
+
+	n = head - tail;
+	if (n > (buf_size / sizeof(pmf_trace_rec_t))) {
+		n = buf_size / sizeof(pmf_trace_rec_t);
+	}
+
+	for (i = 0U; i < n; i++) {
+		buf[i] = ring->rec[(tail + i) & (PMF_TRACE_RING_ENTRIES - 1U)];
+	}
+
+	/*
+	 * The owning CPU may have recorded new events while the records were
+	 * being copied. Drop the ones it could have overwritten, including the
+	 * one in the slot it may be writing right now.
+	 */
+	dmbish();
+	torn = ring->head + 1U - PMF_TRACE_RING_ENTRIES - tail;
+	if ((int)torn > 0) {
+		if (torn > n) {
+			torn = n;
+		}
+		(void)memmove(buf, &buf[torn],
+			      (n - torn) * sizeof(pmf_trace_rec_t));
+		*lost += torn;
+		n -= torn;
+	}
+
+	ring->tail = tail + n + torn;
+	*count = n;
+
+	return 0;
+}
+
+/*
+ * This function retrieves the trace records of the PMF trace services
+ * registered for SMC interface based on `tid` and `mpidr`. The records are
+ * written to the non-secure buffer at physical address `buf_pa`, which must
+ * be page aligned along with its size `buf_size`.
+ */
+int pmf_get_trace_smc(unsigned int tid,
+		u_register_t mpidr,
+		unsigned long long buf_pa,
+		size_t buf_size,
+		unsigned int *count,
+		unsigned int *lost)
+{
+	pmf_svc_desc_t *svc_desc;
+	int cpuid;
+#if PLAT_XLAT_TABLES_DYNAMIC
+	uintptr_t buf_va;
+	int rc;
+#endif
+
+	assert((count != NULL) && (lost != NULL));
+
+	*count = 0U;
+	*lost = 0U;
+
+	/* Search for registered service. */
+	svc_desc = get_service(tid);
+	cpuid = plat_core_pos_by_mpidr(mpidr);
+
+	if ((svc_desc == NULL) || (svc_desc->trace == NULL) || (cpuid < 0)) {
+		return -EINVAL;
+	}
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+	if (((buf_pa & PAGE_SIZE_MASK) != 0U) || (buf_size == 0U) ||
+	    ((buf_size & PAGE_SIZE_MASK) != 0U)) {
+		return -EINVAL;
+	}
+
+	/* The buffer comes from the Normal world, it must be Non-secure memory */
+	if (plat_pmf_validate_trace_buffer(buf_pa, buf_size) != 0) {
+		return -EPERM;
+	}
+
+	spin_lock(&pmf_trace_lock);
+
+	rc = mmap_add_dynamic_region_alloc_va(buf_pa, &buf_va, buf_size,
+					      MT_MEMORY | MT_RW | MT_NS);
+	if (rc == 0) {
+		rc = pmf_drain_trace(&svc_desc->trace[cpuid],
+				     (pmf_trace_rec_t *)buf_va, buf_size,
+				     count, lost);
+
+		if (mmap_remove_dynamic_region(buf_va, buf_size) != 0) {
+			ERROR("PMF: failed to unmap the trace buffer\n");
+			panic();
+		}
+	}
+
+	spin_unlock(&pmf_trace_lock);
+
+	return rc;
+#else
+	/* The buffer of the caller cannot be mapped */
+	return -ENOTSUP;
+#endif
+}
+
+/*
+ * This function records an event with its `payload` and time-stamp `ts` in the
+ * trace ring of the current cpu, among the trace rings `rings`.
+ */
+void __pmf_trace_record(pmf_trace_ring_t *rings,
+			unsigned int tid,
+			unsigned int payload,
+			unsigned long long ts)
+{
+	pmf_trace_ring_t *ring = &rings[plat_my_core_pos()];
+	unsigned int head = ring->head;
+	pmf_trace_rec_t *rec =
+		&ring->rec[head & (PMF_TRACE_RING_ENTRIES - 1U)];
+
+	rec->ts = ts;
+	rec->tid = tid & PMF_TID_MASK;
+	rec->payload = payload;
+
+	/* Publish the record before updating the head */
+	dmbishst();
+	ring->head = head + 1U;
+}
+
 /*
  * This function can be used to dump `ts` value for given `tid`.
  * Assumption is that the console is already initialized.
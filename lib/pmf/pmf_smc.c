@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -25,6 +25,7 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 {
 	int rc;
 	unsigned long long ts_value;
+	unsigned int count, lost;
 
 	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
 
@@ -44,6 +45,21 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 			SMC_RET3(handle, rc, (uint32_t)ts_value,
 					(uint32_t)(ts_value >> 32));
 		}
+
+		if (smc_fid == PMF_SMC_GET_TRACE_32) {
+			/*
+			 * Return error code, the number of trace records
+			 * written to the buffer and the number of records
+			 * lost to the caller.
+			 * x0 --> error code.
+			 * x1 --> number of records retrieved.
+			 * x2 --> number of records lost.
+			 */
+			x4 = (uint32_t)x4;
+			rc = pmf_get_trace_smc((unsigned int)x1, x2, x3, x4,
+					&count, &lost);
+			SMC_RET3(handle, rc, count, lost);
+		}
 	} else {
 		if (smc_fid == PMF_SMC_GET_TIMESTAMP_64) {
 			/*
@@ -56,6 +72,20 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 					(unsigned int)x3, &ts_value);
 			SMC_RET2(handle, rc, ts_value);
 		}
+
+		if (smc_fid == PMF_SMC_GET_TRACE_64) {
+			/*
+			 * Return error code, the number of trace records
+			 * written to the buffer and the number of records
+			 * lost to the caller.
+			 * x0 --> error code.
+			 * x1 --> number of records retrieved.
+			 * x2 --> number of records lost.
+			 */
+			rc = pmf_get_trace_smc((unsigned int)x1, x2, x3, x4,
+					&count, &lost);
+			SMC_RET3(handle, rc, count, lost);
+		}
 	}
 
 	WARN("Unimplemented PMF Call: 0x%x \n", smc_fid);
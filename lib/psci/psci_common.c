@@ -46,6 +46,14 @@ static plat_local_state_t
 
 unsigned int psci_plat_core_count;
 
+#if PSCI_OS_INIT_MODE
+/*
+ * CPU_SUSPEND mode selected by the OS with PSCI_SET_SUSPEND_MODE. The platform
+ * coordinated mode is the default after a cold boot.
+ */
+unsigned int psci_suspend_mode = PSCI_MODE_PLAT_COORD;
+#endif
+
 /*******************************************************************************
  * Arrays that hold the platform's power domain tree information for state
  * management of power domains.
@@ -373,10 +381,10 @@ void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 
 /******************************************************************************
  * This function is invoked post CPU power up and initialization. It sets the
- * affinity info state, target power state and requested power state for the
- * current CPU and all its ancestor power domains to RUN.
+ * target power state and requested power state for the current CPU and all its
+ * ancestor power domains to RUN. The affinity info state is left unchanged.
  *****************************************************************************/
-void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl)
+void psci_set_local_pwr_states_to_run(unsigned int end_pwrlvl)
 {
 	unsigned int parent_idx, cpu_idx = plat_my_core_pos(), lvl;
 	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
@@ -391,11 +399,21 @@ void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl)
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
 
+	psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
+	psci_flush_cpu_data(psci_svc_cpu_data);
+}
+
+/******************************************************************************
+ * This function is invoked post CPU power up and initialization. It sets the
+ * affinity info state, target power state and requested power state for the
+ * current CPU and all its ancestor power domains to RUN.
+ *****************************************************************************/
+void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl)
+{
 	/* Set the affinity info state to ON */
 	psci_set_aff_info_state(AFF_STATE_ON);
 
-	psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
-	psci_flush_cpu_data(psci_svc_cpu_data);
+	psci_set_local_pwr_states_to_run(end_pwrlvl);
 }
 
 /******************************************************************************
@@ -476,6 +494,79 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	psci_set_target_local_pwr_states(end_pwrlvl, state_info);
 }
 
+#if PSCI_OS_INIT_MODE
+/******************************************************************************
+ * This function is the OS-initiated mode counterpart of
+ * psci_do_state_coordination(). The OS has already decided which state each
+ * power domain between the current CPU and the 'end_pwrlvl' enters, so there
+ * is no coordination of the requested states. Instead, the request is checked
+ * against the states of the other CPUs in each of those power domains:
+ *
+ *  - The current CPU has to be the last running CPU in the power domain,
+ *    otherwise PSCI_E_DENIED is returned.
+ *  - The power domain cannot be powered off while one of its CPUs is in a
+ *    retention state, as that CPU expects its context to be preserved. Such
+ *    a request is rejected with PSCI_E_INVALID_PARAMS.
+ *
+ * If the request is valid, the requested states are recorded as the target
+ * states of the power domain nodes. This function is called with the locks of
+ * the power domains up to the 'end_pwrlvl' held.
+ *****************************************************************************/
+int psci_validate_state_coordination(unsigned int end_pwrlvl,
+				     const psci_power_state_t *state_info)
+{
+	unsigned int lvl, parent_idx, idx, cpu_idx = plat_my_core_pos();
+	unsigned int start_idx, end_idx;
+	plat_local_state_t req_state, cpu_state;
+
+	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
+	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
+		req_state = state_info->pwr_domain_state[lvl];
+		start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+		end_idx = start_idx + psci_non_cpu_pd_nodes[parent_idx].ncpus;
+
+		for (idx = start_idx; idx < end_idx; idx++) {
+			if (idx == cpu_idx)
+				continue;
+
+#if !HW_ASSISTED_COHERENCY
+			/*
+			 * The other CPU may have updated its local state with
+			 * the data cache disabled.
+			 */
+			flush_cpu_data_by_index(idx,
+						psci_svc_cpu_data.local_state);
+#endif
+			cpu_state = psci_get_cpu_local_state_by_idx(idx);
+
+			if (is_local_state_run(cpu_state) != 0) {
+				VERBOSE("core=%u is still running at level %u\n",
+					idx, lvl);
+				return PSCI_E_DENIED;
+			}
+
+			if ((is_local_state_off(req_state) != 0) &&
+			    (is_local_state_retn(cpu_state) != 0))
+				return PSCI_E_INVALID_PARAMS;
+		}
+
+		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+	}
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
+		psci_set_req_local_pwr_state(lvl, cpu_idx,
+					     state_info->pwr_domain_state[lvl]);
+	}
+
+	/* Update the target state in the power domain nodes */
+	psci_set_target_local_pwr_states(end_pwrlvl, state_info);
+
+	return PSCI_E_SUCCESS;
+}
+#endif /* PSCI_OS_INIT_MODE */
+
 /******************************************************************************
  * This function validates a suspend request by making sure that if a standby
  * state is requested then no power level is turned off and the highest power
@@ -773,6 +864,7 @@ void psci_warmboot_entrypoint(void)
 	unsigned int cpu_idx = plat_my_core_pos();
 	unsigned int parent_nodes[PLAT_MAX_PWR_LVL] = {0};
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
+	bool cpu_on;
 
 	/*
 	 * Verify that we have been explicitly turned ON or resumed from
@@ -817,16 +909,21 @@ void psci_warmboot_entrypoint(void)
 	 * of power management handler and perform the generic, architecture
 	 * and platform specific handling.
 	 */
-	if (psci_get_aff_info_state() == AFF_STATE_ON_PENDING)
+	cpu_on = (psci_get_aff_info_state() == AFF_STATE_ON_PENDING);
+	if (cpu_on)
 		psci_cpu_on_finish(cpu_idx, &state_info);
 	else
 		psci_cpu_suspend_finish(cpu_idx, &state_info);
 
 	/*
 	 * Set the requested and target state of this CPU and all the higher
-	 * power domains which are ancestors of this CPU to run.
+	 * power domains which are ancestors of this CPU to run. This is done
+	 * under the locks, so that other CPUs coordinating the state of these
+	 * power domains see this CPU running. A CPU resuming from suspend is
+	 * already ON. A CPU that has just been turned on is only published as
+	 * ON by psci_cpu_on_finish_unlocked().
 	 */
-	psci_set_pwr_domains_to_run(end_pwrlvl);
+	psci_set_local_pwr_states_to_run(end_pwrlvl);
 
 #if ENABLE_PSCI_STAT
 	/*
@@ -843,6 +940,15 @@ void psci_warmboot_entrypoint(void)
 	 * in the reverse order to which they were acquired.
 	 */
 	psci_release_pwr_domain_locks(end_pwrlvl, parent_nodes);
+
+	/*
+	 * The rest of the work of a CPU that has just been turned on only
+	 * concerns this CPU, so it is done without holding the locks. This
+	 * lets the CPUs of a power domain turned on at the same time run it
+	 * concurrently.
+	 */
+	if (cpu_on)
+		psci_cpu_on_finish_unlocked(cpu_idx);
 }
 
 /*******************************************************************************
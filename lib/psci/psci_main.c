@@ -83,8 +83,13 @@ int psci_cpu_suspend(unsigned int power_state,
 		panic();
 	}
 
-	/* Fast path for CPU standby.*/
-	if (is_cpu_standby_req(is_power_down_state, target_pwrlvl)) {
+	/*
+	 * Fast path for CPU standby. It is not taken in OS-initiated mode, as
+	 * the CPU would then neither be seen as idle by the last CPU of its
+	 * power domains nor restore these power domains when woken up.
+	 */
+	if (is_cpu_standby_req(is_power_down_state, target_pwrlvl) &&
+	    !psci_is_os_init_mode()) {
 		if  (psci_plat_pm_ops->cpu_standby == NULL)
 			return PSCI_E_INVALID_PARAMS;
 
@@ -140,14 +145,13 @@ int psci_cpu_suspend(unsigned int power_state,
 	 * Do what is needed to enter the power down state. Upon success,
 	 * enter the final wfi which will power down this CPU. This function
 	 * might return if the power down was abandoned for any reason, e.g.
-	 * arrival of an interrupt
+	 * arrival of an interrupt, or if the request was rejected in
+	 * OS-initiated mode.
 	 */
-	psci_cpu_suspend_start(&ep,
-			    target_pwrlvl,
-			    &state_info,
-			    is_power_down_state);
-
-	return PSCI_E_SUCCESS;
+	return psci_cpu_suspend_start(&ep,
+				      target_pwrlvl,
+				      &state_info,
+				      is_power_down_state);
 }
 
 
@@ -187,12 +191,10 @@ int psci_system_suspend(uintptr_t entrypoint, u_register_t context_id)
 	 * might return if the power down was abandoned for any reason, e.g.
 	 * arrival of an interrupt
 	 */
-	psci_cpu_suspend_start(&ep,
-			    PLAT_MAX_PWR_LVL,
-			    &state_info,
-			    PSTATE_TYPE_POWERDOWN);
-
-	return PSCI_E_SUCCESS;
+	return psci_cpu_suspend_start(&ep,
+				      PLAT_MAX_PWR_LVL,
+				      &state_info,
+				      PSTATE_TYPE_POWERDOWN);
 }
 
 int psci_cpu_off(void)
@@ -333,6 +335,50 @@ int psci_node_hw_state(u_register_t target_cpu,
 	return rc;
 }
 
+#if PSCI_OS_INIT_MODE
+int psci_set_suspend_mode(unsigned int mode)
+{
+	unsigned int cpu_idx, my_idx = plat_my_core_pos();
+	unsigned int parent_nodes[PLAT_MAX_PWR_LVL] = {0};
+	int rc = PSCI_E_SUCCESS;
+
+	if ((mode != PSCI_MODE_PLAT_COORD) && (mode != PSCI_MODE_OS_INIT))
+		return PSCI_E_INVALID_PARAMS;
+
+	if (mode == psci_suspend_mode)
+		return PSCI_E_SUCCESS;
+
+	psci_get_parent_pwr_domain_nodes(my_idx, PLAT_MAX_PWR_LVL, parent_nodes);
+	psci_acquire_pwr_domain_locks(PLAT_MAX_PWR_LVL, parent_nodes);
+
+	/*
+	 * The two modes track idle CPUs differently, so the mode can only be
+	 * changed while no CPU is suspended. The other CPUs must either be
+	 * running or be turned off.
+	 */
+	for (cpu_idx = 0U; cpu_idx < psci_plat_core_count; cpu_idx++) {
+		if (cpu_idx == my_idx)
+			continue;
+
+		flush_cpu_data_by_index(cpu_idx, psci_svc_cpu_data);
+
+		if ((psci_get_aff_info_state_by_idx(cpu_idx) == AFF_STATE_ON) &&
+		    (is_local_state_run(
+				psci_get_cpu_local_state_by_idx(cpu_idx)) == 0)) {
+			rc = PSCI_E_DENIED;
+			break;
+		}
+	}
+
+	if (rc == PSCI_E_SUCCESS)
+		psci_suspend_mode = mode;
+
+	psci_release_pwr_domain_locks(PLAT_MAX_PWR_LVL, parent_nodes);
+
+	return rc;
+}
+#endif
+
 int psci_features(unsigned int psci_fid)
 {
 	unsigned int local_caps = psci_caps;
@@ -357,12 +403,11 @@ int psci_features(unsigned int psci_fid)
 	/* Format the feature flags */
 	if ((psci_fid == PSCI_CPU_SUSPEND_AARCH32) ||
 	    (psci_fid == PSCI_CPU_SUSPEND_AARCH64)) {
-		/*
-		 * The trusted firmware does not support OS Initiated Mode.
-		 */
-		unsigned int ret = ((FF_PSTATE << FF_PSTATE_SHIFT) |
-			(((FF_SUPPORTS_OS_INIT_MODE == 1U) ? 0U : 1U)
-				<< FF_MODE_SUPPORT_SHIFT));
+		unsigned int ret = FF_PSTATE << FF_PSTATE_SHIFT;
+
+#if PSCI_OS_INIT_MODE
+		ret |= FF_SUPPORTS_OS_INIT_MODE << FF_MODE_SUPPORT_SHIFT;
+#endif
 		return (int) ret;
 	}
 
@@ -439,6 +484,12 @@ u_register_t psci_smc_handler(uint32_t smc_fid,
 			ret = (u_register_t)psci_system_suspend(r1, r2);
 			break;
 
+#if PSCI_OS_INIT_MODE
+		case PSCI_SET_SUSPEND_MODE:
+			ret = (u_register_t)psci_set_suspend_mode(r1);
+			break;
+#endif
+
 		case PSCI_SYSTEM_OFF:
 			psci_system_off();
 			/* We should never return from psci_system_off() */
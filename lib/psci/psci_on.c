@@ -162,9 +162,16 @@ exit:
 }
 
 /*******************************************************************************
- * The following function finish an earlier power on request. They
+ * The following functions finish an earlier power on request. They
  * are called by the common finisher routine in psci_common.c. The `state_info`
  * is the psci_power_state from which this CPU has woken up from.
+ *
+ * psci_cpu_on_finish() is called with the locks of the parent power domains
+ * held. It only performs the platform actions, which may act on the parent
+ * power domains. psci_cpu_on_finish_unlocked() is called once the locks are
+ * released, and performs the rest of the work, which only concerns this cpu.
+ * The cpu is still ON_PENDING while it does so, and it only publishes itself
+ * as ON once it is ready to enter the normal world.
  ******************************************************************************/
 void psci_cpu_on_finish(unsigned int cpu_idx, const psci_power_state_t *state_info)
 {
@@ -191,10 +198,17 @@ void psci_cpu_on_finish(unsigned int cpu_idx, const psci_power_state_t *state_in
 	if (psci_plat_pm_ops->pwr_domain_on_finish_late != NULL)
 		psci_plat_pm_ops->pwr_domain_on_finish_late(state_info);
 
+	/* Ensure we have been explicitly woken up by another cpu */
+	assert(psci_get_aff_info_state() == AFF_STATE_ON_PENDING);
+}
+
+void psci_cpu_on_finish_unlocked(unsigned int cpu_idx)
+{
 	/*
 	 * All the platform specific actions for turning this cpu
 	 * on have completed. Perform enough arch.initialization
-	 * to run in the non-secure address space.
+	 * to run in the non-secure address space. This only programs
+	 * registers and per-cpu data of this cpu.
 	 */
 	psci_arch_setup();
 
@@ -202,18 +216,18 @@ void psci_cpu_on_finish(unsigned int cpu_idx, const psci_power_state_t *state_in
 	 * Lock the CPU spin lock to make sure that the context initialization
 	 * is done. Since the lock is only used in this function to create
 	 * a synchronization point with cpu_on_start(), it can be released
-	 * immediately.
+	 * immediately. cpu_on_start() does not take the locks of the power
+	 * domains, so it never had to wait for them.
 	 */
 	psci_spin_lock_cpu(cpu_idx);
 	psci_spin_unlock_cpu(cpu_idx);
 
-	/* Ensure we have been explicitly woken up by another cpu */
-	assert(psci_get_aff_info_state() == AFF_STATE_ON_PENDING);
-
 	/*
 	 * Call the cpu on finish handler registered by the Secure Payload
 	 * Dispatcher to let it do any bookeeping. If the handler encounters an
-	 * error, it's expected to assert within
+	 * error, it's expected to assert within. It needs the counter
+	 * frequency programmed by psci_arch_setup(), and only enters the
+	 * secure context of this cpu.
 	 */
 	if ((psci_spd_pm != NULL) && (psci_spd_pm->svc_on_finish != NULL))
 		psci_spd_pm->svc_on_finish(0);
@@ -224,6 +238,16 @@ void psci_cpu_on_finish(unsigned int cpu_idx, const psci_power_state_t *state_in
 	/* This needs to be done only once */
 	psci_cpu_pd_nodes[cpu_idx].mpidr = read_mpidr() & MPIDR_AFFINITY_MASK;
 
+	/*
+	 * Publish the cpu as ON. Other cpus only act on this cpu, or read its
+	 * mpidr, once it is ON, so the bookkeeping above must be visible to
+	 * them first. This is the only place where an ON_PENDING cpu becomes
+	 * ON, so no lock is needed.
+	 */
+	dmbish();
+	psci_set_aff_info_state(AFF_STATE_ON);
+	psci_flush_cpu_data(psci_svc_cpu_data.aff_info_state);
+
 	/*
 	 * Generic management: Now we just need to retrieve the
 	 * information that we had stashed away during the cpu_on
@@ -168,10 +168,11 @@ typedef struct cpu_pwr_domain_node {
  ******************************************************************************/
 #if HW_ASSISTED_COHERENCY
 /*
- * On systems where participant CPUs are cache-coherent, we can use spinlocks
- * instead of bakery locks.
+ * On systems where participant CPUs are cache-coherent, we can use ticket locks
+ * instead of bakery locks. Unlike bakery locks, their cost does not depend on
+ * the number of CPUs, and unlike spinlocks, they bound the wait of each CPU.
  */
-#define DEFINE_PSCI_LOCK(_name)		spinlock_t _name
+#define DEFINE_PSCI_LOCK(_name)		ticket_lock_t _name
 #define DECLARE_PSCI_LOCK(_name)	extern DEFINE_PSCI_LOCK(_name)
 
 /* One lock is required per non-CPU power domain node */
@@ -198,18 +199,19 @@ static inline void psci_dsbish(void)
 
 static inline void psci_lock_get(non_cpu_pd_node_t *non_cpu_pd_node)
 {
-	spin_lock(&psci_locks[non_cpu_pd_node->lock_index]);
+	ticket_lock(&psci_locks[non_cpu_pd_node->lock_index]);
 }
 
 static inline void psci_lock_release(non_cpu_pd_node_t *non_cpu_pd_node)
 {
-	spin_unlock(&psci_locks[non_cpu_pd_node->lock_index]);
+	ticket_unlock(&psci_locks[non_cpu_pd_node->lock_index]);
 }
 
 #else /* if HW_ASSISTED_COHERENCY == 0 */
 /*
  * Use bakery locks for state coordination as not all PSCI participants are
- * cache coherent.
+ * cache coherent: CPUs powering up take these locks before they have joined
+ * the coherency domain.
  */
 #define DEFINE_PSCI_LOCK(_name)		DEFINE_BAKERY_LOCK(_name)
 #define DECLARE_PSCI_LOCK(_name)	DECLARE_BAKERY_LOCK(_name)
@@ -260,6 +262,22 @@ extern non_cpu_pd_node_t psci_non_cpu_pd_nodes[PSCI_NUM_NON_CPU_PWR_DOMAINS];
 extern cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
 extern unsigned int psci_caps;
 extern unsigned int psci_plat_core_count;
+#if PSCI_OS_INIT_MODE
+extern unsigned int psci_suspend_mode;
+#endif
+
+/*
+ * Helper function to check whether CPU_SUSPEND requests currently follow the
+ * OS-initiated semantics selected through PSCI_SET_SUSPEND_MODE.
+ */
+static inline bool psci_is_os_init_mode(void)
+{
+#if PSCI_OS_INIT_MODE
+	return psci_suspend_mode == PSCI_MODE_OS_INIT;
+#else
+	return false;
+#endif
+}
 
 /*******************************************************************************
  * SPD's power management hooks registered with PSCI
@@ -284,6 +302,10 @@ void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 				      unsigned int *node_index);
 void psci_do_state_coordination(unsigned int end_pwrlvl,
 				psci_power_state_t *state_info);
+#if PSCI_OS_INIT_MODE
+int psci_validate_state_coordination(unsigned int end_pwrlvl,
+				     const psci_power_state_t *state_info);
+#endif
 void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl,
 				   const unsigned int *parent_nodes);
 void psci_release_pwr_domain_locks(unsigned int end_pwrlvl,
@@ -293,6 +315,7 @@ int psci_validate_suspend_req(const psci_power_state_t *state_info,
 unsigned int psci_find_max_off_lvl(const psci_power_state_t *state_info);
 unsigned int psci_find_target_suspend_lvl(const psci_power_state_t *state_info);
 void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl);
+void psci_set_local_pwr_states_to_run(unsigned int end_pwrlvl);
 void psci_print_power_domain_map(void);
 bool psci_is_last_on_cpu(void);
 int psci_spd_migrate_info(u_register_t *mpidr);
@@ -312,12 +335,13 @@ int psci_cpu_on_start(u_register_t target_cpu,
 		      const entry_point_info_t *ep);
 
 void psci_cpu_on_finish(unsigned int cpu_idx, const psci_power_state_t *state_info);
+void psci_cpu_on_finish_unlocked(unsigned int cpu_idx);
 
 /* Private exported functions from psci_off.c */
 int psci_do_cpu_off(unsigned int end_pwrlvl);
 
 /* Private exported functions from psci_suspend.c */
-void psci_cpu_suspend_start(const entry_point_info_t *ep,
+int psci_cpu_suspend_start(const entry_point_info_t *ep,
 			unsigned int end_pwrlvl,
 			psci_power_state_t *state_info,
 			unsigned int is_power_down_state);
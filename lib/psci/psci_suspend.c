@@ -147,18 +147,26 @@ static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
  * level if the cpu is the last in the cluster and also the program the power
  * controller.
  *
+ * In OS-initiated mode, the requested states are not coordinated but validated
+ * against the states of the other CPUs, and the request may be rejected. The
+ * CPU then wakes up through all the power levels up to PLAT_MAX_PWR_LVL, as a
+ * power domain above 'end_pwrlvl' may have been suspended by another CPU in
+ * the meantime.
+ *
  * All the required parameter checks are performed at the beginning and after
  * the state transition has been done, no further error is expected and it is
  * not possible to undo any of the actions taken beyond that point.
  ******************************************************************************/
-void psci_cpu_suspend_start(const entry_point_info_t *ep,
-			    unsigned int end_pwrlvl,
-			    psci_power_state_t *state_info,
-			    unsigned int is_power_down_state)
+int psci_cpu_suspend_start(const entry_point_info_t *ep,
+			   unsigned int end_pwrlvl,
+			   psci_power_state_t *state_info,
+			   unsigned int is_power_down_state)
 {
+	int rc = PSCI_E_SUCCESS;
 	int skip_wfi = 0;
 	unsigned int idx = plat_my_core_pos();
 	unsigned int parent_nodes[PLAT_MAX_PWR_LVL] = {0};
+	unsigned int wake_pwrlvl = end_pwrlvl;
 
 	/*
 	 * This function must only be called on platforms where the
@@ -187,12 +195,30 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 		goto exit;
 	}
 
-	/*
-	 * This function is passed the requested state info and
-	 * it returns the negotiated state info for each power level upto
-	 * the end level specified.
-	 */
-	psci_do_state_coordination(end_pwrlvl, state_info);
+#if PSCI_OS_INIT_MODE
+	if (psci_is_os_init_mode()) {
+		/*
+		 * The requested state info is the final state info, provided
+		 * it is consistent with the state of the other CPUs.
+		 */
+		rc = psci_validate_state_coordination(end_pwrlvl, state_info);
+		if (rc != PSCI_E_SUCCESS) {
+			skip_wfi = 1;
+			goto exit;
+		}
+
+		wake_pwrlvl = PLAT_MAX_PWR_LVL;
+	} else {
+#endif
+		/*
+		 * This function is passed the requested state info and
+		 * it returns the negotiated state info for each power level
+		 * upto the end level specified.
+		 */
+		psci_do_state_coordination(end_pwrlvl, state_info);
+#if PSCI_OS_INIT_MODE
+	}
+#endif
 
 #if ENABLE_PSCI_STAT
 	/* Update the last cpu for each level till end_pwrlvl */
@@ -200,7 +226,7 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 #endif
 
 	if (is_power_down_state != 0U)
-		psci_suspend_to_pwrdown_start(end_pwrlvl, ep, state_info);
+		psci_suspend_to_pwrdown_start(wake_pwrlvl, ep, state_info);
 
 	/*
 	 * Plat. management: Allow the platform to perform the
@@ -222,7 +248,7 @@ exit:
 	psci_release_pwr_domain_locks(end_pwrlvl, parent_nodes);
 
 	if (skip_wfi == 1)
-		return;
+		return rc;
 
 	if (is_power_down_state != 0U) {
 #if ENABLE_RUNTIME_INSTRUMENTATION
@@ -249,6 +275,9 @@ exit:
 	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
 	    RT_INSTR_ENTER_HW_LOW_PWR,
 	    PMF_NO_CACHE_MAINT);
+	PMF_TRACE_EVENT(rt_trace_svc,
+	    RT_INSTR_ENTER_HW_LOW_PWR,
+	    end_pwrlvl);
 #endif
 
 	/*
@@ -262,13 +291,18 @@ exit:
 	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
 	    RT_INSTR_EXIT_HW_LOW_PWR,
 	    PMF_NO_CACHE_MAINT);
+	PMF_TRACE_EVENT(rt_trace_svc,
+	    RT_INSTR_EXIT_HW_LOW_PWR,
+	    end_pwrlvl);
 #endif
 
 	/*
 	 * After we wake up from context retaining suspend, call the
 	 * context retaining suspend finisher.
 	 */
-	psci_suspend_to_standby_finisher(idx, end_pwrlvl);
+	psci_suspend_to_standby_finisher(idx, wake_pwrlvl);
+
+	return PSCI_E_SUCCESS;
 }
 
 /*******************************************************************************
@@ -280,6 +314,9 @@ void psci_cpu_suspend_finish(unsigned int cpu_idx, const psci_power_state_t *sta
 {
 	unsigned int counter_freq;
 	unsigned int max_off_lvl;
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	unsigned long long suspend_ts, wakeup_ts;
+#endif
 
 	/* Ensure we have been woken up from a suspended state */
 	assert((psci_get_aff_info_state() == AFF_STATE_ON) &&
@@ -300,6 +337,25 @@ void psci_cpu_suspend_finish(unsigned int cpu_idx, const psci_power_state_t *sta
 	psci_do_pwrup_cache_maintenance();
 #endif
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	/*
+	 * The power down and wake-up timestamps were captured with the data
+	 * cache off, so they are read back from memory. The trace ring cannot
+	 * be written safely with the data cache off, so both events of a power
+	 * down suspend are only recorded now. Their timestamps are those of the
+	 * events themselves.
+	 */
+	max_off_lvl = psci_find_max_off_lvl(state_info);
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc, RT_INSTR_ENTER_HW_LOW_PWR,
+				   cpu_idx, PMF_CACHE_MAINT, suspend_ts);
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc, RT_INSTR_EXIT_HW_LOW_PWR,
+				   cpu_idx, PMF_CACHE_MAINT, wakeup_ts);
+	PMF_WRITE_TRACE_EVENT(rt_trace_svc, RT_INSTR_ENTER_HW_LOW_PWR,
+			      max_off_lvl, suspend_ts);
+	PMF_WRITE_TRACE_EVENT(rt_trace_svc, RT_INSTR_EXIT_HW_LOW_PWR,
+			      max_off_lvl, wakeup_ts);
+#endif
+
 	/* Re-init the cntfrq_el0 register */
 	counter_freq = plat_get_syscnt_freq2();
 	write_cntfrq_el0(counter_freq);
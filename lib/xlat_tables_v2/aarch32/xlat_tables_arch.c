@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -103,6 +103,22 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime)
 	}
 }
 
+/*
+ * Above this number of pages, xlat_arch_tlbi_va_range() invalidates the whole
+ * translation regime instead of one page at a time.
+ */
+#define XLAT_TLBI_VA_MAX_PAGES	XLAT_TABLE_ENTRIES
+
+static void xlat_arch_tlbi_page(uintptr_t va, int xlat_regime)
+{
+	if (xlat_regime == EL1_EL0_REGIME) {
+		tlbimvaais(TLBI_ADDR(va));
+	} else {
+		assert(xlat_regime == EL2_REGIME);
+		tlbimvahis(TLBI_ADDR(va));
+	}
+}
+
 void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 {
 	/*
@@ -111,11 +127,34 @@ void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 	 */
 	dsbishst();
 
-	if (xlat_regime == EL1_EL0_REGIME) {
-		tlbimvaais(TLBI_ADDR(va));
-	} else {
-		assert(xlat_regime == EL2_REGIME);
-		tlbimvahis(TLBI_ADDR(va));
+	xlat_arch_tlbi_page(va, xlat_regime);
+}
+
+void xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime)
+{
+	size_t pages = size >> PAGE_SIZE_SHIFT;
+
+	assert(IS_PAGE_ALIGNED(va) && IS_PAGE_ALIGNED(size));
+
+	/*
+	 * Ensure the translation table writes have drained into memory before
+	 * invalidating the TLB entries. AArch32 has no range operations.
+	 */
+	dsbishst();
+
+	if (pages > XLAT_TLBI_VA_MAX_PAGES) {
+		if (xlat_regime == EL1_EL0_REGIME) {
+			tlbiallis();
+		} else {
+			assert(xlat_regime == EL2_REGIME);
+			tlbiallhis();
+		}
+		return;
+	}
+
+	for (; pages > 0U; pages--) {
+		xlat_arch_tlbi_page(va, xlat_regime);
+		va += PAGE_SIZE;
 	}
 }
 
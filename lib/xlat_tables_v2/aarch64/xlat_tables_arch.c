@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -184,14 +184,15 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime)
 	}
 }
 
-void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
-{
-	/*
-	 * Ensure the translation table write has drained into memory before
-	 * invalidating the TLB entry.
-	 */
-	dsbishst();
+/*
+ * Above this number of pages, xlat_arch_tlbi_va_range() invalidates the whole
+ * translation regime instead of one page at a time when FEAT_TLBIRANGE isn't
+ * implemented.
+ */
+#define XLAT_TLBI_VA_MAX_PAGES	XLAT_TABLE_ENTRIES
 
+static void xlat_arch_tlbi_page(uintptr_t va, int xlat_regime)
+{
 	/*
 	 * This function only supports invalidation of TLB entries for the EL3
 	 * and EL1&0 translation regimes.
@@ -212,6 +213,106 @@ void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 	}
 }
 
+static void xlat_arch_tlbi_range(uint64_t range, int xlat_regime)
+{
+	if (xlat_regime == EL1_EL0_REGIME) {
+		assert(xlat_arch_current_el() >= 1U);
+		tlbirvaae1is(range);
+	} else if (xlat_regime == EL2_REGIME) {
+		assert(xlat_arch_current_el() >= 2U);
+		tlbirvae2is(range);
+	} else {
+		assert(xlat_regime == EL3_REGIME);
+		assert(xlat_arch_current_el() >= 3U);
+		tlbirvae3is(range);
+	}
+}
+
+static void xlat_arch_tlbi_all(int xlat_regime)
+{
+	if (xlat_regime == EL1_EL0_REGIME) {
+		assert(xlat_arch_current_el() >= 1U);
+		tlbivmalle1is();
+	} else if (xlat_regime == EL2_REGIME) {
+		assert(xlat_arch_current_el() >= 2U);
+		tlbialle2is();
+	} else {
+		assert(xlat_regime == EL3_REGIME);
+		assert(xlat_arch_current_el() >= 3U);
+		tlbialle3is();
+	}
+}
+
+void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
+{
+	/*
+	 * Ensure the translation table write has drained into memory before
+	 * invalidating the TLB entry.
+	 */
+	dsbishst();
+
+	xlat_arch_tlbi_page(va, xlat_regime);
+}
+
+void xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime)
+{
+	unsigned long pages = (unsigned long)size >> PAGE_SIZE_SHIFT;
+	unsigned int scale = 0U;
+
+	assert(IS_PAGE_ALIGNED(va) && IS_PAGE_ALIGNED(size));
+
+	/*
+	 * Ensure the translation table writes have drained into memory before
+	 * invalidating the TLB entries.
+	 */
+	dsbishst();
+
+	if (!is_armv8_4_tlbirange_present() ||
+	    (pages >= TLBI_RANGE_MAX_PAGES)) {
+		if (pages > XLAT_TLBI_VA_MAX_PAGES) {
+			xlat_arch_tlbi_all(xlat_regime);
+			return;
+		}
+
+		for (; pages > 0UL; pages--) {
+			xlat_arch_tlbi_page(va, xlat_regime);
+			va += PAGE_SIZE;
+		}
+		return;
+	}
+
+	/*
+	 * A range operation covers an even number of pages, so an odd page at
+	 * the start is invalidated on its own. The rest is covered by at most
+	 * one range operation per scale, from the smallest to the largest one,
+	 * each of them taking the bits of the page count that it can encode.
+	 */
+	if ((pages & 1UL) != 0UL) {
+		xlat_arch_tlbi_page(va, xlat_regime);
+		va += PAGE_SIZE;
+		pages--;
+	}
+
+	while (pages > 0UL) {
+		unsigned long num = (pages >> ((5U * scale) + 1U)) &
+				    TLBI_RANGE_NUM_MASK;
+
+		assert(scale <= TLBI_RANGE_SCALE_MAX);
+
+		if (num != 0UL) {
+			unsigned long range_pages =
+				TLBI_RANGE_PAGES(num - 1UL, scale);
+
+			xlat_arch_tlbi_range(TLBI_RANGE(va, num - 1UL, scale),
+					     xlat_regime);
+			va += range_pages << PAGE_SIZE_SHIFT;
+			pages -= range_pages;
+		}
+
+		scale++;
+	}
+}
+
 void xlat_arch_tlbi_va_sync(void)
 {
 	/*
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -352,7 +352,8 @@ static action_t xlat_tables_unmap_region_action(const mmap_region_t *mm,
 }
 /*
  * Recursive function that writes to the translation tables and unmaps the
- * specified region.
+ * specified region. The caller is responsible for invalidating the TLB entries
+ * of the whole region once the tables have been updated.
  */
 static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 				     const uintptr_t table_base_va,
@@ -389,7 +390,6 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
 			table_base[table_idx] = INVALID_DESC;
-			xlat_arch_tlbi_va(table_idx_va, ctx->xlat_regime);
 
 		} else if (action == ACTION_RECURSE_INTO_TABLE) {
 
@@ -408,8 +408,6 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 			 */
 			if (xlat_table_is_empty(ctx, subtable)) {
 				table_base[table_idx] = INVALID_DESC;
-				xlat_arch_tlbi_va(table_idx_va,
-						  ctx->xlat_regime);
 			}
 
 		} else {
@@ -561,6 +559,49 @@ static action_t xlat_tables_map_region_action(const mmap_region_t *mm,
 	}
 }
 
+/*
+ * Returns true if the XLAT_CONT_ENTRIES entries of the table starting at the
+ * given one can be mapped as a run of block or page descriptors with the
+ * Contiguous hint set. The run has to be aligned in VA and PA, fully covered by
+ * the region and still unused, so that all of its entries are written here with
+ * the same attributes. The region can't be overlapped later on: static regions
+ * are mapped inner ones first and dynamic regions can't overlap at all.
+ */
+static bool xlat_tables_cont_run_fits(const mmap_region_t *mm,
+				      const uint64_t *table_base,
+				      unsigned int table_entries,
+				      unsigned int table_idx,
+				      uintptr_t table_idx_va,
+				      unsigned long long table_idx_pa,
+				      unsigned int level)
+{
+	unsigned long long run_size = (unsigned long long)XLAT_CONT_ENTRIES *
+				      XLAT_BLOCK_SIZE(level);
+
+	if ((((unsigned long long)table_idx_va & (run_size - 1ULL)) != 0ULL) ||
+	    ((table_idx_pa & (run_size - 1ULL)) != 0ULL)) {
+		return false;
+	}
+
+	if ((table_idx + XLAT_CONT_ENTRIES) > table_entries) {
+		return false;
+	}
+
+	assert(table_idx_va >= mm->base_va);
+	if (((unsigned long long)(table_idx_va - mm->base_va) + run_size) >
+	    (unsigned long long)mm->size) {
+		return false;
+	}
+
+	for (unsigned int i = 0U; i < XLAT_CONT_ENTRIES; i++) {
+		if ((table_base[table_idx + i] & DESC_MASK) != INVALID_DESC) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /*
  * Recursive function that writes to the translation tables and maps the
  * specified region. On success, it returns the VA of the last byte that was
@@ -584,6 +625,7 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 	uint64_t desc;
 
 	unsigned int table_idx;
+	unsigned int cont_end_idx = 0U;
 
 	table_idx_va = xlat_tables_find_start_va(mm, table_base_va, level);
 	table_idx = xlat_tables_va_to_index(table_base_va, table_idx_va, level);
@@ -605,9 +647,19 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
-			table_base[table_idx] =
-				xlat_desc(ctx, (uint32_t)mm->attr, table_idx_pa,
-					  level);
+			if ((table_idx >= cont_end_idx) &&
+			    xlat_tables_cont_run_fits(mm, table_base,
+					table_entries, table_idx, table_idx_va,
+					table_idx_pa, level)) {
+				cont_end_idx = table_idx + XLAT_CONT_ENTRIES;
+			}
+
+			desc = xlat_desc(ctx, (uint32_t)mm->attr, table_idx_pa,
+					 level);
+			if (table_idx < cont_end_idx) {
+				desc |= UPPER_ATTRS(CONT_HINT);
+			}
+			table_base[table_idx] = desc;
 
 		} else if (action == ACTION_CREATE_NEW_TABLE) {
 			uintptr_t end_va;
@@ -1037,6 +1089,9 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 			xlat_clean_dcache_range((uintptr_t)ctx->base_table,
 				ctx->base_table_entries * sizeof(uint64_t));
 #endif
+			xlat_arch_tlbi_va_range(unmap_mm.base_va,
+				unmap_mm.size, ctx->xlat_regime);
+			xlat_arch_tlbi_va_sync();
 			return -ENOMEM;
 		}
 
@@ -1123,6 +1178,8 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 		xlat_clean_dcache_range((uintptr_t)ctx->base_table,
 			ctx->base_table_entries * sizeof(uint64_t));
 #endif
+		xlat_arch_tlbi_va_range(mm->base_va, mm->size,
+					ctx->xlat_regime);
 		xlat_arch_tlbi_va_sync();
 	}
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -63,8 +63,17 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime);
 void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime);
 
 /*
- * This function has to be called at the end of any code that uses the function
- * xlat_arch_tlbi_va().
+ * Invalidate all TLB entries that match any virtual address in the given
+ * range, which must be page aligned. It has the same scope as
+ * xlat_arch_tlbi_va(). If FEAT_TLBIRANGE is implemented, the range is covered
+ * with as few TLBI instructions as possible. Otherwise, pages are invalidated
+ * one by one, or the whole translation regime if the range is too large.
+ */
+void xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime);
+
+/*
+ * This function has to be called at the end of any code that uses the
+ * functions xlat_arch_tlbi_va() or xlat_arch_tlbi_va_range().
  */
 void xlat_arch_tlbi_va_sync(void);
 
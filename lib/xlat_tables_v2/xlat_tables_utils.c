@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -537,52 +537,117 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 	/* Restore original value. */
 	base_va = base_va_original;
 
-	for (unsigned int i = 0U; i < pages_count; ++i) {
+	uintptr_t end_va = base_va_original + size;
+	uintptr_t run_size = (uintptr_t)XLAT_CONT_ENTRIES * PAGE_SIZE;
 
-		uint32_t old_attr = 0U, new_attr;
+	/*
+	 * The pages are updated in batches of at most one aligned run of
+	 * XLAT_CONT_ENTRIES pages, so that the TLB entries of each batch are
+	 * invalidated at once.
+	 */
+	while (base_va < end_va) {
+		uint64_t new_desc[XLAT_CONT_ENTRIES];
 		uint64_t *entry = NULL;
-		unsigned int level = 0U;
-		unsigned long long addr_pa = 0ULL;
+		uint32_t run_attr = 0U;
+		uintptr_t run_va = base_va & ~(run_size - 1U);
+		uintptr_t batch_va = base_va;
+		uintptr_t batch_end_va = run_va + run_size;
+		uint64_t cont_hint = 0ULL;
+		unsigned int batch_pages;
+
+		if (batch_end_va > end_va) {
+			batch_end_va = end_va;
+		}
 
-		(void) xlat_get_mem_attributes_internal(ctx, base_va, &old_attr,
-					    &entry, &addr_pa, &level);
+		(void) xlat_get_mem_attributes_internal(ctx, base_va,
+				&run_attr, &entry, NULL, NULL);
 
 		/*
-		 * From attr, only MT_RO/MT_RW, MT_EXECUTE/MT_EXECUTE_NEVER and
-		 * MT_USER/MT_PRIVILEGED are taken into account. Any other
-		 * information is ignored.
+		 * All the pages of a run with the Contiguous hint must have the
+		 * same attributes. If the range only covers part of the run,
+		 * rewrite all of it without the hint. If it covers all of it,
+		 * the attributes are changed in the same way for all the pages
+		 * and the hint can be kept.
 		 */
+		if ((*entry & UPPER_ATTRS(CONT_HINT)) != 0U) {
+			entry -= (base_va - run_va) / PAGE_SIZE;
+			if ((run_va == base_va) &&
+			    (batch_end_va == (run_va + run_size))) {
+				cont_hint = UPPER_ATTRS(CONT_HINT);
+			}
+			batch_va = run_va;
+			batch_end_va = run_va + run_size;
+		}
 
-		/* Clean the old attributes so that they can be rebuilt. */
-		new_attr = old_attr & ~(MT_RW | MT_EXECUTE_NEVER | MT_USER);
+		batch_pages = (unsigned int)((batch_end_va - batch_va) /
+					     PAGE_SIZE);
+
+		for (unsigned int i = 0U; i < batch_pages; ++i) {
+			uintptr_t page_va = batch_va + (i * PAGE_SIZE);
+			uint32_t old_attr = 0U, new_attr;
+			unsigned int level = 0U;
+			unsigned long long addr_pa = 0ULL;
+
+			if ((page_va < base_va_original) ||
+			    (page_va >= end_va)) {
+				/* Outside of the range, only drop the hint. */
+				new_desc[i] = entry[i] &
+					      ~UPPER_ATTRS(CONT_HINT);
+				continue;
+			}
 
-		/*
-		 * Update attributes, but filter out the ones this function
-		 * isn't allowed to change.
-		 */
-		new_attr |= attr & (MT_RW | MT_EXECUTE_NEVER | MT_USER);
+			(void) xlat_get_mem_attributes_internal(ctx, page_va,
+					&old_attr, NULL, &addr_pa, &level);
+
+			/*
+			 * From attr, only MT_RO/MT_RW,
+			 * MT_EXECUTE/MT_EXECUTE_NEVER and MT_USER/MT_PRIVILEGED
+			 * are taken into account. Any other information is
+			 * ignored.
+			 */
+
+			/* Clean the old attributes so that they can be rebuilt */
+			new_attr = old_attr &
+				   ~(MT_RW | MT_EXECUTE_NEVER | MT_USER);
+
+			/*
+			 * Update attributes, but filter out the ones this
+			 * function isn't allowed to change.
+			 */
+			new_attr |= attr & (MT_RW | MT_EXECUTE_NEVER | MT_USER);
+
+			new_desc[i] = xlat_desc(ctx, new_attr, addr_pa, level) |
+				      cont_hint;
+		}
 
 		/*
-		 * The break-before-make sequence requires writing an invalid
-		 * descriptor and making sure that the system sees the change
-		 * before writing the new descriptor.
+		 * The break-before-make sequence requires writing invalid
+		 * descriptors and making sure that the system sees the change
+		 * before writing the new descriptors.
 		 */
-		*entry = INVALID_DESC;
+		for (unsigned int i = 0U; i < batch_pages; ++i) {
+			entry[i] = INVALID_DESC;
 #if !HW_ASSISTED_COHERENCY
-		dccvac((uintptr_t)entry);
+			dccvac((uintptr_t)&entry[i]);
 #endif
-		/* Invalidate any cached copy of this mapping in the TLBs. */
-		xlat_arch_tlbi_va(base_va, ctx->xlat_regime);
+		}
+
+		/* Invalidate any cached copy of these mappings in the TLBs. */
+		xlat_arch_tlbi_va_range(batch_va, batch_end_va - batch_va,
+					ctx->xlat_regime);
 
 		/* Ensure completion of the invalidation. */
 		xlat_arch_tlbi_va_sync();
 
-		/* Write new descriptor */
-		*entry = xlat_desc(ctx, new_attr, addr_pa, level);
+		/* Write new descriptors */
+		for (unsigned int i = 0U; i < batch_pages; ++i) {
+			entry[i] = new_desc[i];
 #if !HW_ASSISTED_COHERENCY
-		dccvac((uintptr_t)entry);
+			dccvac((uintptr_t)&entry[i]);
 #endif
-		base_va += PAGE_SIZE;
+		}
+
+		base_va = batch_end_va;
 	}
 
 	/* Ensure that the last descriptor writen is seen by the system. */
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2018-2021, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <common/debug.h>
@@ -48,32 +49,34 @@ static void ZLIB_INTERNAL zfree(void *opaque, void *ptr)
 {
 }
 
+/* State of the decompression started by gunzip_stream_start() */
+static z_stream stream;
+static bool stream_ended;
+
 /*
- * gunzip - decompress gzip data
- * @in_buf: source of compressed input. Upon exit, the end of input.
- * @in_len: length of in_buf
- * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * gunzip_stream_start - start decompressing gzip data given piece by piece
+ * @out_buf: destination of decompressed output
  * @out_len: length of out_buf
  * @work_buf: workspace
  * @work_len: length of workspace
  */
-int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
-	   size_t out_len, uintptr_t work_buf, size_t work_len)
+int gunzip_stream_start(uintptr_t out_buf, size_t out_len, uintptr_t work_buf,
+			size_t work_len)
 {
-	z_stream stream;
-	int zret, ret;
+	int zret;
 
 	zalloc_start = work_buf;
 	zalloc_end = work_buf + work_len;
 	zalloc_current = zalloc_start;
 
-	stream.next_in = (typeof(stream.next_in))*in_buf;
-	stream.avail_in = in_len;
-	stream.next_out = (typeof(stream.next_out))*out_buf;
+	stream.next_in = Z_NULL;
+	stream.avail_in = 0U;
+	stream.next_out = (typeof(stream.next_out))out_buf;
 	stream.avail_out = out_len;
 	stream.zalloc = zcalloc;
 	stream.zfree = zfree;
 	stream.opaque = (voidpf)0;
+	stream_ended = false;
 
 	zret = inflateInit(&stream);
 	if (zret != Z_OK) {
@@ -81,20 +84,63 @@ int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 		return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
 	}
 
+	return 0;
+}
+
+/*
+ * gunzip_stream_update - decompress the next piece of gzip data
+ * @in_buf: source of compressed input
+ * @in_len: length of in_buf
+ *
+ * Input past the end of the compressed data is ignored.
+ */
+int gunzip_stream_update(uintptr_t in_buf, size_t in_len)
+{
+	int zret;
+
+	if (stream_ended || (in_len == 0U)) {
+		return 0;
+	}
+
+	stream.next_in = (typeof(stream.next_in))in_buf;
+	stream.avail_in = in_len;
+
 	zret = inflate(&stream, Z_NO_FLUSH);
 	if (zret == Z_STREAM_END) {
-		ret = 0;
-	} else {
-		if (stream.msg)
-			ERROR("%s\n", stream.msg);
-		ERROR("zlib: inflate failed (ret = %d)\n", zret);
-		ret = (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+		stream_ended = true;
+		return 0;
+	}
+
+	/* All the input must have been consumed, or the output is full */
+	if ((zret == Z_OK) && (stream.avail_in == 0U)) {
+		return 0;
+	}
+
+	if (stream.msg)
+		ERROR("%s\n", stream.msg);
+	ERROR("zlib: inflate failed (ret = %d)\n", zret);
+
+	return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+}
+
+/*
+ * gunzip_stream_end - finish decompressing gzip data
+ * @out_buf: upon exit, the end of output
+ *
+ * Fails if the compressed data ended early.
+ */
+int gunzip_stream_end(uintptr_t *out_buf)
+{
+	int ret = 0;
+
+	if (!stream_ended) {
+		ERROR("zlib: compressed data is truncated\n");
+		ret = -EIO;
 	}
 
 	VERBOSE("zlib: %lu byte input\n", stream.total_in);
 	VERBOSE("zlib: %lu byte output\n", stream.total_out);
 
-	*in_buf = (uintptr_t)stream.next_in;
 	*out_buf = (uintptr_t)stream.next_out;
 
 	inflateEnd(&stream);
@@ -102,6 +148,41 @@ int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	return ret;
 }
 
+const decompressor_stream_t gunzip_stream = {
+	.start = gunzip_stream_start,
+	.update = gunzip_stream_update,
+	.end = gunzip_stream_end,
+};
+
+/*
+ * gunzip - decompress gzip data
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace
+ * @work_len: length of workspace
+ */
+int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	   size_t out_len, uintptr_t work_buf, size_t work_len)
+{
+	int ret;
+
+	ret = gunzip_stream_start(*out_buf, out_len, work_buf, work_len);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = gunzip_stream_update(*in_buf, in_len);
+	*in_buf = (uintptr_t)stream.next_in;
+	if (ret != 0) {
+		(void)gunzip_stream_end(out_buf);
+		return ret;
+	}
+
+	return gunzip_stream_end(out_buf);
+}
+
 /* Wrapper function to calculate CRC
  * @crc: previous accumulated CRC
  * @buf: buffer base address
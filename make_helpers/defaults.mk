@@ -228,6 +228,9 @@ HASH_ALG			:= sha256
 # operations.
 HW_ASSISTED_COHERENCY		:= 0
 
+# Decompress compressed images while they are loaded, before authentication
+IMAGE_DECOMPRESS_STREAM		:= 0
+
 # Set the default algorithm for the generation of Trusted Board Boot keys
 KEY_ALG				:= rsa
 
@@ -255,6 +258,9 @@ PROGRAMMABLE_RESET_ADDRESS	:= 0
 # Flag used to choose the power state format: Extended State-ID or Original
 PSCI_EXTENDED_STATE_ID		:= 0
 
+# Flag to enable support for the PSCI OS-initiated suspend mode
+PSCI_OS_INIT_MODE		:= 0
+
 # Enable RAS support
 RAS_EXTENSION			:= 0
 
@@ -298,9 +304,17 @@ SPD				:= none
 # Enable the Management Mode (MM)-based Secure Partition Manager implementation
 SPM_MM				:= 0
 
+# Allocate per-CPU execution contexts for MM Secure Partitions that register a
+# secondary entry point
+SPM_MM_MULTI_THREADED		:= 0
+
 # Use the FF-A SPMC implementation in EL3.
 SPMC_AT_EL3			:= 0
 
+# Add a Logical Partition to the EL3 SPMC reporting the SP service time of
+# direct messages.
+SPMC_BENCHMARK_LP		:= 0
+
 # Use SPM at S-EL2 as a default config for SPMD
 SPMD_SPM_AT_SEL2		:= 1
 
@@ -405,6 +419,12 @@ ENABLE_LTO			:= 0
 # Default is 0.
 CTX_INCLUDE_EL2_REGS		:= 0
 
+# Build flag to only save the EL2 register groups a security state is able to
+# modify, and to skip restoring the larger groups that did not change, when the
+# SPMD and RMMD switch between security states. Requires CTX_INCLUDE_EL2_REGS.
+# Default is 0.
+CTX_EL2_REGS_LAZY_SWITCH	:= 0
+
 # Enable Memory tag extension which is supported for architecture greater
 # than Armv8.5-A
 # By default it is set to "no"
@@ -109,9 +109,14 @@
 /*
  * Number of Logical Partitions supported.
  * SPMC at EL3, uses this count to configure the maximum number of supported
- * logical partitions.
+ * logical partitions. The benchmark partition comes in addition to the
+ * platform one when enabled.
  */
+#if SPMC_BENCHMARK_LP
+#define MAX_EL3_LP_DESCS_COUNT		2
+#else
 #define MAX_EL3_LP_DESCS_COUNT		1
+#endif
 
 #endif /* SPMC_AT_EL3 */
 
@@ -459,6 +459,10 @@ ENABLE_SYS_REG_TRACE_FOR_NS	:= 1
 # enable trace filter control registers access to NS by default
 ENABLE_TRF_FOR_NS		:= 1
 
+# give each CPU its own execution context in an MM Secure Partition that
+# registers a secondary entry point
+SPM_MM_MULTI_THREADED		:= 1
+
 ifeq (${SPMC_AT_EL3}, 1)
 PLAT_BL_COMMON_SOURCES	+=	plat/arm/board/fvp/fvp_el3_spmc.c
 endif
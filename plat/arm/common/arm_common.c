@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2021, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -237,6 +237,32 @@ int plat_sdei_validate_entry_point(uintptr_t ep, unsigned int client_mode)
 }
 #endif
 
+/*
+ * Check that the buffer in which PMF trace records are retrieved lies entirely
+ * within one of the Non-secure DRAM regions.
+ */
+int plat_pmf_validate_trace_buffer(unsigned long long base, size_t size)
+{
+	unsigned long long end = base + size;
+
+	if ((size == 0U) || (end < base)) {
+		return -1;
+	}
+
+	if ((base >= ARM_NS_DRAM1_BASE) &&
+	    (end <= (ARM_NS_DRAM1_BASE + ARM_NS_DRAM1_SIZE))) {
+		return 0;
+	}
+#ifdef __aarch64__
+	if ((base >= ARM_DRAM2_BASE) &&
+	    (end <= (ARM_DRAM2_BASE + ARM_DRAM2_SIZE))) {
+		return 0;
+	}
+#endif
+
+	return -1;
+}
+
 const mmap_region_t *plat_get_addr_mmap(void)
 {
 	return plat_arm_mmap;
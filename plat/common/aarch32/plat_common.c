@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,9 +13,20 @@
  * platforms but may also be overridden by a platform if required.
  */
 #pragma weak bl32_plat_enable_mmu
+#pragma weak plat_pmf_validate_trace_buffer
 
 
 void bl32_plat_enable_mmu(uint32_t flags)
 {
 	enable_mmu_svc_mon(flags);
 }
+
+/*
+ * Default function to validate the buffer in which PMF trace records are
+ * retrieved. Nothing is known about the Non-secure memory, so it fails and the
+ * records cannot be retrieved until the platform provides its own check.
+ */
+int plat_pmf_validate_trace_buffer(unsigned long long base, size_t size)
+{
+	return -1;
+}
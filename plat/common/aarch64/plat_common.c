@@ -31,6 +31,8 @@
 
 #pragma weak plat_ea_handler = plat_default_ea_handler
 
+#pragma weak plat_pmf_validate_trace_buffer
+
 void bl31_plat_runtime_setup(void)
 {
 	console_switch_state(CONSOLE_FLAG_RUNTIME);
@@ -67,6 +69,16 @@ int plat_sdei_validate_entry_point(uintptr_t ep, unsigned int client_mode)
 }
 #endif
 
+/*
+ * Default function to validate the buffer in which PMF trace records are
+ * retrieved. Nothing is known about the Non-secure memory, so it fails and the
+ * records cannot be retrieved until the platform provides its own check.
+ */
+int plat_pmf_validate_trace_buffer(unsigned long long base, size_t size)
+{
+	return -1;
+}
+
 const char *get_el_str(unsigned int el)
 {
 	if (el == MODE_EL3) {
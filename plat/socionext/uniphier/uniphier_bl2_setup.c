@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -121,6 +121,9 @@ void bl2_plat_preload_setup(void)
 		plat_error_handler(ret);
 
 	image_decompress_init(buf_base, UNIPHIER_IMAGE_BUF_SIZE, gunzip);
+#if IMAGE_DECOMPRESS_STREAM
+	image_decompress_stream_init(&gunzip_stream);
+#endif
 #endif
 
 	uniphier_init_image_descs(uniphier_mem_base);
@@ -71,6 +71,13 @@ static io_block_dev_spec_t mmc_block_dev_spec = {
 		.write = NULL,
 	},
 	.block_size = MMC_BLOCK_SIZE,
+	/*
+	 * The SDMMC2 driver transfers to any block-aligned buffer, by DMA or
+	 * through its FIFO. 1MB keeps a transfer well within its 1s data
+	 * timeout.
+	 */
+	.direct = true,
+	.direct_max_length = SZ_1M,
 };
 
 static const io_dev_connector_t *mmc_dev_con;
@@ -650,6 +650,9 @@ REGISTER_CRYPTO_LIB("stm32_crypto_lib",
 		    crypto_lib_init,
 		    crypto_verify_signature,
 		    crypto_verify_hash,
+		    NULL,
+		    NULL,
+		    NULL,
 		    crypto_auth_decrypt);
 
 #else /* No decryption support */
@@ -657,6 +660,9 @@ REGISTER_CRYPTO_LIB("stm32_crypto_lib",
 		    crypto_lib_init,
 		    crypto_verify_signature,
 		    crypto_verify_hash,
+		    NULL,
+		    NULL,
+		    NULL,
 		    NULL);
 
 #endif
@@ -172,3 +172,23 @@ DECLARE_RT_SVC(
 		NULL,
 		arm_arch_svc_smc_handler
 );
+
+/*
+ * Calls that only return a value are served on the fast path, without going
+ * through the runtime service dispatch.
+ */
+DECLARE_RT_SVC_FAST(smccc_version, SMCCC_VERSION, arm_arch_svc_smc_handler);
+DECLARE_RT_SVC_FAST(smccc_arch_features, SMCCC_ARCH_FEATURES,
+		    arm_arch_svc_smc_handler);
+#if WORKAROUND_CVE_2017_5715
+DECLARE_RT_SVC_FAST(smccc_arch_workaround_1, SMCCC_ARCH_WORKAROUND_1,
+		    arm_arch_svc_smc_handler);
+#endif
+#if WORKAROUND_CVE_2018_3639
+DECLARE_RT_SVC_FAST(smccc_arch_workaround_2, SMCCC_ARCH_WORKAROUND_2,
+		    arm_arch_svc_smc_handler);
+#endif
+#if (WORKAROUND_CVE_2022_23960 || WORKAROUND_CVE_2017_5715)
+DECLARE_RT_SVC_FAST(smccc_arch_workaround_3, SMCCC_ARCH_WORKAROUND_3,
+		    arm_arch_svc_smc_handler);
+#endif
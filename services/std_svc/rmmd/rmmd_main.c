@@ -19,6 +19,8 @@
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/pubsub.h>
 #include <lib/gpt_rme/gpt_rme.h>
+#include <lib/pmf/pmf.h>
+#include <lib/runtime_instr.h>
 
 #include <lib/spinlock.h>
 #include <lib/utils.h>
@@ -248,15 +250,34 @@ static uint64_t	rmmd_smc_forward(uint32_t src_sec_state,
 {
 	cpu_context_t *ctx = cm_get_context(dst_sec_state);
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		RT_INSTR_ENTER_WORLD_SWITCH,
+		PMF_NO_CACHE_MAINT);
+#endif
+
 	/* Save incoming security state */
 	cm_el1_sysregs_context_save(src_sec_state);
+#if CTX_EL2_REGS_LAZY_SWITCH
+	/* Save and restore the EL2 state in one go. */
+	cm_el2_sysregs_context_switch(src_sec_state, dst_sec_state);
+#else
 	cm_el2_sysregs_context_save(src_sec_state);
+#endif
 
 	/* Restore outgoing security state */
 	cm_el1_sysregs_context_restore(dst_sec_state);
+#if !CTX_EL2_REGS_LAZY_SWITCH
 	cm_el2_sysregs_context_restore(dst_sec_state);
+#endif
 	cm_set_next_eret_context(dst_sec_state);
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		RT_INSTR_EXIT_WORLD_SWITCH,
+		PMF_NO_CACHE_MAINT);
+#endif
+
 	/*
 	 * As per SMCCCv1.2, we need to preserve x4 to x7 unless
 	 * being used as return args. Hence we differentiate the
@@ -400,6 +421,16 @@ static int gpt_to_gts_error(int error, uint32_t smc_fid, uint64_t address)
 	return ret;
 }
 
+/*
+ * Part of the range of a GTSI range request transitioned by a single SMC. The
+ * RMM issues the request again for the rest of the range.
+ */
+static size_t gtsi_range_chunk(uint64_t size)
+{
+	return (size > GPT_MAX_TRANSITION_SIZE) ?
+		GPT_MAX_TRANSITION_SIZE : (size_t)size;
+}
+
 /*******************************************************************************
  * This function handles RMM-EL3 interface SMCs
  ******************************************************************************/
@@ -408,6 +439,7 @@ uint64_t rmmd_rmm_el3_handler(uint32_t smc_fid, uint64_t x1, uint64_t x2,
 				void *handle, uint64_t flags)
 {
 	uint32_t src_sec_state;
+	size_t size;
 	int ret;
 
 	/* If RMM failed to boot, treat any RMM-EL3 interface SMC as unknown */
@@ -431,6 +463,16 @@ uint64_t rmmd_rmm_el3_handler(uint32_t smc_fid, uint64_t x1, uint64_t x2,
 	case RMM_GTSI_UNDELEGATE:
 		ret = gpt_undelegate_pas(x1, PAGE_SIZE_4KB, SMC_FROM_REALM);
 		SMC_RET1(handle, gpt_to_gts_error(ret, smc_fid, x1));
+	case RMM_GTSI_DELEGATE_RANGE:
+		size = gtsi_range_chunk(x2);
+		ret = gpt_delegate_pas(x1, size, SMC_FROM_REALM);
+		SMC_RET2(handle, gpt_to_gts_error(ret, smc_fid, x1),
+			 (ret == 0) ? size : 0UL);
+	case RMM_GTSI_UNDELEGATE_RANGE:
+		size = gtsi_range_chunk(x2);
+		ret = gpt_undelegate_pas(x1, size, SMC_FROM_REALM);
+		SMC_RET2(handle, gpt_to_gts_error(ret, smc_fid, x1),
+			 (ret == 0) ? size : 0UL);
 	case RMM_ATTEST_GET_PLAT_TOKEN:
 		ret = rmmd_attest_get_platform_token(x1, &x2, x3);
 		SMC_RET2(handle, ret, x2);
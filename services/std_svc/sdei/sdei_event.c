@@ -6,6 +6,7 @@
 
 #include <assert.h>
 
+#include <lib/spinlock.h>
 #include <lib/utils.h>
 
 #include "sdei_private.h"
@@ -51,6 +52,108 @@ sdei_entry_t *get_event_entry(sdei_ev_map_t *map)
 	}
 }
 
+/*
+ * The mappings are indexed by event number and by interrupt in two hash tables
+ * using linear probing, declared by REGISTER_SDEI_MAP().
+ *
+ * The event number index is filled when the mappings are initialised and does
+ * not change afterwards. The interrupt index holds the mappings bound to an
+ * interrupt, plus event 0. Dynamic mappings are added and removed as they are
+ * bound and released, under sdei_intr_index_lock. Lookups don't take the lock:
+ * a slot always holds either NULL, a mapping or INDEX_SLOT_FREED, and the key
+ * is read from the mapping itself. Removed mappings leave INDEX_SLOT_FREED
+ * behind so that lookups carry on probing past them.
+ */
+static sdei_ev_map_t index_slot_freed;
+#define INDEX_SLOT_FREED	(&index_slot_freed)
+
+static spinlock_t sdei_intr_index_lock;
+
+static unsigned int index_hash(uint32_t key)
+{
+	/* Multiplicative hashing spreads consecutive numbers */
+	return (unsigned int) ((key * 0x9e3779b1U) % sdei_global_index.num_slots);
+}
+
+static unsigned int index_next(unsigned int slot)
+{
+	slot++;
+
+	return (slot == sdei_global_index.num_slots) ? 0U : slot;
+}
+
+static void ev_index_add(sdei_ev_map_t *map)
+{
+	sdei_ev_map_t **slots = sdei_global_index.ev_slots;
+	unsigned int slot = index_hash((uint32_t) map->ev_num);
+
+	/*
+	 * The table has more slots than there are mappings. If the event
+	 * number is already present, keep the first mapping for it.
+	 */
+	while (slots[slot] != NULL) {
+		if (slots[slot]->ev_num == map->ev_num)
+			return;
+		slot = index_next(slot);
+	}
+
+	slots[slot] = map;
+}
+
+/*
+ * Add a mapping to the interrupt index. The caller must make sure the mapping
+ * is not already in it.
+ */
+void sdei_intr_index_add(sdei_ev_map_t *map)
+{
+	sdei_ev_map_t **slots = sdei_global_index.intr_slots;
+	unsigned int slot = index_hash(map->intr);
+
+	spin_lock(&sdei_intr_index_lock);
+
+	while ((slots[slot] != NULL) && (slots[slot] != INDEX_SLOT_FREED))
+		slot = index_next(slot);
+
+	slots[slot] = map;
+
+	spin_unlock(&sdei_intr_index_lock);
+}
+
+/*
+ * Remove a mapping from the interrupt index. This must be called before the
+ * interrupt of the mapping is changed.
+ */
+void sdei_intr_index_remove(sdei_ev_map_t *map)
+{
+	sdei_ev_map_t **slots = sdei_global_index.intr_slots;
+	unsigned int i, slot = index_hash(map->intr);
+
+	spin_lock(&sdei_intr_index_lock);
+
+	for (i = 0U; (i < sdei_global_index.num_slots) && (slots[slot] != NULL);
+			i++) {
+		if (slots[slot] == map) {
+			slots[slot] = INDEX_SLOT_FREED;
+			break;
+		}
+		slot = index_next(slot);
+	}
+
+	spin_unlock(&sdei_intr_index_lock);
+}
+
+/*
+ * Index an initialised mapping. Mappings bound to an interrupt and event 0
+ * are also indexed by interrupt.
+ */
+void sdei_index_map(sdei_ev_map_t *map)
+{
+	ev_index_add(map);
+
+	if (is_map_bound(map) || (map->ev_num == SDEI_EVENT_0))
+		sdei_intr_index_add(map);
+}
+
 /*
  * Find event mapping for a given interrupt number: On success, returns pointer
  * to the event mapping. On error, returns NULL.
@@ -58,18 +161,36 @@ sdei_entry_t *get_event_entry(sdei_ev_map_t *map)
 sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
 {
 	const sdei_mapping_t *mapping;
-	sdei_ev_map_t *map;
-	unsigned int i;
+	sdei_ev_map_t *map, **slots;
+	unsigned int i, slot;
 
 	/*
-	 * Look for a match in private and shared mappings, as requested. This
-	 * is a linear search. However, if the mappings are required to be
-	 * sorted, for large maps, we could consider binary search.
+	 * Unbound dynamic mappings are not indexed. Looking for one is only
+	 * needed to bind a new interrupt, so a linear search is fine.
 	 */
-	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
-	iterate_mapping(mapping, i, map) {
-		if (map->intr == intr_num)
+	if (intr_num == SDEI_DYN_IRQ) {
+		mapping = shared ? SDEI_SHARED_MAPPING() :
+			SDEI_PRIVATE_MAPPING();
+		iterate_mapping(mapping, i, map) {
+			if (map->intr == intr_num)
+				return map;
+		}
+
+		return NULL;
+	}
+
+	slots = sdei_global_index.intr_slots;
+	slot = index_hash(intr_num);
+	for (i = 0U; i < sdei_global_index.num_slots; i++) {
+		map = slots[slot];
+		if (map == NULL)
+			break;
+
+		if ((map != INDEX_SLOT_FREED) && (map->intr == intr_num) &&
+				(is_event_shared(map) == shared))
 			return map;
+
+		slot = index_next(slot);
 	}
 
 	return NULL;
@@ -81,20 +202,14 @@ sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
  */
 sdei_ev_map_t *find_event_map(int ev_num)
 {
-	const sdei_mapping_t *mapping;
-	sdei_ev_map_t *map;
-	unsigned int i, j;
+	sdei_ev_map_t *map, **slots = sdei_global_index.ev_slots;
+	unsigned int slot = index_hash((uint32_t) ev_num);
 
-	/*
-	 * Iterate through mappings to find a match. This is a linear search.
-	 * However, if the mappings are required to be sorted, for large maps,
-	 * we could consider binary search.
-	 */
-	for_each_mapping_type(i, mapping) {
-		iterate_mapping(mapping, j, map) {
-			if (map->ev_num == ev_num)
-				return map;
-		}
+	/* The table is never full, so the probe ends on an empty slot */
+	for (map = slots[slot]; map != NULL; map = slots[slot]) {
+		if (map->ev_num == ev_num)
+			return map;
+		slot = index_next(slot);
 	}
 
 	return NULL;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -145,6 +145,7 @@ static void sdei_class_init(sdei_class_t class)
 		}
 
 		init_map(map);
+		sdei_index_map(map);
 	}
 
 	/* Sanity check and configuration of private events for this CPU */
@@ -217,6 +218,7 @@ static void sdei_class_init(sdei_class_t class)
 		}
 
 		init_map(map);
+		sdei_index_map(map);
 	}
 
 	/* Ensure event 0 is in the mapping */
@@ -766,6 +768,7 @@ static int sdei_interrupt_bind(unsigned int intr_num)
 		if (!is_map_bound(map)) {
 			map->intr = intr_num;
 			set_map_bound(map);
+			sdei_intr_index_add(map);
 			retry = false;
 		}
 		sdei_map_unlock(map);
@@ -823,6 +826,7 @@ static int sdei_interrupt_release(int ev_num)
 		 * during unregister.
 		 */
 
+		sdei_intr_index_remove(map);
 		map->intr = SDEI_DYN_IRQ;
 		clr_map_bound(map);
 	} else {
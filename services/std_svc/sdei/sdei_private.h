@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -227,9 +227,13 @@ static inline void sdei_map_unlock(sdei_ev_map_t *map)
 extern const sdei_mapping_t sdei_global_mappings[];
 extern sdei_entry_t sdei_private_event_table[];
 extern sdei_entry_t sdei_shared_event_table[];
+extern const sdei_index_t sdei_global_index;
 
 void init_sdei_state(void);
 
+void sdei_index_map(sdei_ev_map_t *map);
+void sdei_intr_index_add(sdei_ev_map_t *map);
+void sdei_intr_index_remove(sdei_ev_map_t *map);
 sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared);
 sdei_ev_map_t *find_event_map(int ev_num);
 sdei_entry_t *get_event_entry(sdei_ev_map_t *map);
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2022, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <lib/pmf/pmf.h>
+#include <lib/runtime_instr.h>
+#include <plat/common/platform.h>
+#include <services/el3_spmc_logical_sp.h>
+#include <services/ffa_svc.h>
+#include <smccc_helpers.h>
+
+/*
+ * Logical Partition reporting the SP service time of the last direct message
+ * sent by the Normal world to an SP on the calling CPU, i.e. the time elapsed
+ * between the SPMC forwarding the request to the SP and forwarding the SP
+ * response back. The world switches to and from the Normal world are not part
+ * of it. It is meant to be called by a Normal world benchmark right after each
+ * direct request sent to the SP under test.
+ */
+#define BENCH_LP_PARTITION_ID	0xC0B0
+#define BENCH_LP_UUID {0x2e6fa8b4, 0x3a7c4f12, 0x9d5e61c8, 0xb04f7a35}
+
+/* The benchmark partition only supports receipt of direct messaging. */
+#define BENCH_LP_PROPERTIES	FFA_PARTITION_DIRECT_REQ_RECV
+
+static int32_t bench_lp_init(void)
+{
+	INFO("Benchmark LSP: Init function called.\n");
+	return 0;
+}
+
+static uint64_t bench_lp_direct_request(uint32_t smc_fid, bool secure_origin,
+					uint64_t x1, uint64_t x2, uint64_t x3,
+					uint64_t x4, void *cookie,
+					void *handle, uint64_t flags)
+{
+	unsigned int cpu = plat_my_core_pos();
+	unsigned long long req_ts, resp_ts, switch_in_ts, switch_out_ts;
+	uint64_t service_time = 0ULL;
+	uint64_t switch_time = 0ULL;
+	uint32_t ret;
+
+	/* Determine if we have a 64 or 32 direct request. */
+	if (smc_fid == FFA_MSG_SEND_DIRECT_REQ_SMC32) {
+		ret = FFA_MSG_SEND_DIRECT_RESP_SMC32;
+	} else if (smc_fid == FFA_MSG_SEND_DIRECT_REQ_SMC64) {
+		ret = FFA_MSG_SEND_DIRECT_RESP_SMC64;
+	} else {
+		panic(); /* Unknown SMC. */
+	}
+
+	/*
+	 * The SPMC records when it forwards a direct request to an SP and when
+	 * it forwards the SP direct response back to the Normal world. Both
+	 * time-stamps are taken on the same CPU, so report their difference in
+	 * system counter ticks as long as a complete exchange was recorded.
+	 */
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc,
+		RT_INSTR_ENTER_FFA_DIRECT_REQ, cpu, PMF_NO_CACHE_MAINT,
+		req_ts);
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc,
+		RT_INSTR_EXIT_FFA_DIRECT_RESP, cpu, PMF_NO_CACHE_MAINT,
+		resp_ts);
+
+	if ((req_ts != 0ULL) && (resp_ts >= req_ts)) {
+		service_time = resp_ts - req_ts;
+	}
+
+	/*
+	 * This request is handled in EL3, so the last world switch recorded on
+	 * this CPU is the one that forwarded the SP direct response.
+	 */
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc,
+		RT_INSTR_ENTER_WORLD_SWITCH, cpu, PMF_NO_CACHE_MAINT,
+		switch_in_ts);
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc,
+		RT_INSTR_EXIT_WORLD_SWITCH, cpu, PMF_NO_CACHE_MAINT,
+		switch_out_ts);
+
+	if ((switch_in_ts != 0ULL) && (switch_out_ts >= switch_in_ts)) {
+		switch_time = switch_out_ts - switch_in_ts;
+	}
+
+	/*
+	 * Return the SP service time in x4, the frequency of the system counter
+	 * in x5 so the caller can convert it to a duration, and the duration of
+	 * the world switch to the Normal world in x6.
+	 */
+	SMC_RET8(handle, ret,
+		 ((uint64_t)ffa_endpoint_destination(x1) <<
+		  FFA_DIRECT_MSG_SOURCE_SHIFT) | ffa_endpoint_source(x1),
+		 0, 0, service_time, read_cntfrq_el0(), switch_time, 0);
+}
+
+/* Register the benchmark logical partition. */
+DECLARE_LOGICAL_PARTITION(
+	benchmark_logical_partition,
+	bench_lp_init,			/* Init Function */
+	BENCH_LP_PARTITION_ID,		/* FF-A Partition ID */
+	BENCH_LP_UUID,			/* UUID */
+	BENCH_LP_PROPERTIES,		/* Partition Properties. */
+	bench_lp_direct_request		/* Callback for direct requests. */
+);
@@ -178,6 +178,13 @@ struct secure_partition_desc {
 	 * management transactions if it is using FF-A v1.0.
 	 */
 	bool ns_bit_requested;
+
+	/*
+	 * Store whether the SP has declared that it does not change its EL1
+	 * configuration once initialized, in which case only the volatile part
+	 * of its EL1 context is saved when it sends a direct response.
+	 */
+	bool static_el1_config;
 };
 
 /*
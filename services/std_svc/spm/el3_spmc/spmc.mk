@@ -22,6 +22,14 @@ SPMC_LP_SOURCES  := $(addprefix ${PLAT_DIR}/, \
 
 SPMC_SOURCES += $(SPMC_LP_SOURCES)
 
+# Add the Logical Partition reporting the SP service time of direct messages.
+ifeq (${SPMC_BENCHMARK_LP},1)
+        ifneq (${ENABLE_RUNTIME_INSTRUMENTATION},1)
+                $(error "Error: SPMC_BENCHMARK_LP requires ENABLE_RUNTIME_INSTRUMENTATION=1")
+        endif
+        SPMC_SOURCES	+=	services/std_svc/spm/el3_spmc/logical_sp_bench.c
+endif
+
 # Let the top-level Makefile know that we intend to include a BL32 image
 NEED_BL32		:=	yes
 
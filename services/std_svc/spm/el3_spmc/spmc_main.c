@@ -16,6 +16,8 @@
 #include <common/runtime_svc.h>
 #include <common/uuid.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/pmf/pmf.h>
+#include <lib/runtime_instr.h>
 #include <lib/smccc.h>
 #include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
@@ -47,6 +49,22 @@ static struct secure_partition_desc sp_desc[SECURE_PARTITION_COUNT];
  */
 static struct ns_endpoint_desc ns_ep_desc[NS_PARTITION_COUNT];
 
+/*
+ * Dispatch table mapping the ID of each secure endpoint managed by the SPMC,
+ * i.e. the EL3 Logical Partitions and the SPs, to its descriptor. Exactly one
+ * of the two descriptor pointers is valid in an entry. The table is sorted by
+ * endpoint ID and populated once at boot so that the routing of direct messages
+ * does not need to scan the descriptor arrays.
+ */
+struct spmc_ep_dispatch {
+	uint16_t ep_id;
+	struct el3_lp_desc *lp;
+	struct secure_partition_desc *sp;
+};
+
+static struct spmc_ep_dispatch ep_dispatch[MAX_SP_LP_PARTITIONS];
+static unsigned int ep_dispatch_count;
+
 static uint64_t spmc_sp_interrupt_handler(uint32_t id,
 					  uint32_t flags,
 					  void *handle,
@@ -80,18 +98,66 @@ struct sp_exec_ctx *spmc_get_sp_ec(struct secure_partition_desc *sp)
 	return &(sp->ec[get_ec_index(sp)]);
 }
 
-/* Helper function to get pointer to SP context from its ID. */
-struct secure_partition_desc *spmc_get_sp_ctx(uint16_t id)
+/*
+ * Helper function to add a secure endpoint to the dispatch table. Endpoints are
+ * added at boot, once their ID has been validated.
+ */
+static void spmc_ep_dispatch_add(uint16_t id, struct el3_lp_desc *lp,
+				 struct secure_partition_desc *sp)
 {
-	/* Check for Secure World Partitions. */
-	for (unsigned int i = 0U; i < SECURE_PARTITION_COUNT; i++) {
-		if (sp_desc[i].sp_id == id) {
-			return &(sp_desc[i]);
+	unsigned int i;
+
+	assert(ep_dispatch_count < ARRAY_SIZE(ep_dispatch));
+
+	/* Keep the table sorted by moving larger IDs up by one entry. */
+	for (i = ep_dispatch_count; i > 0U; i--) {
+		if (ep_dispatch[i - 1U].ep_id < id) {
+			break;
+		}
+		ep_dispatch[i] = ep_dispatch[i - 1U];
+	}
+
+	ep_dispatch[i].ep_id = id;
+	ep_dispatch[i].lp = lp;
+	ep_dispatch[i].sp = sp;
+	ep_dispatch_count++;
+}
+
+/* Helper function to look up a secure endpoint in the dispatch table. */
+static struct spmc_ep_dispatch *spmc_ep_dispatch_get(uint16_t id)
+{
+	unsigned int lo = 0U;
+	unsigned int hi = ep_dispatch_count;
+
+	while (lo < hi) {
+		unsigned int mid = (lo + hi) / 2U;
+
+		if (ep_dispatch[mid].ep_id == id) {
+			return &ep_dispatch[mid];
+		}
+
+		if (ep_dispatch[mid].ep_id < id) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
 		}
 	}
+
 	return NULL;
 }
 
+/* Helper function to get pointer to SP context from its ID. */
+struct secure_partition_desc *spmc_get_sp_ctx(uint16_t id)
+{
+	struct spmc_ep_dispatch *ep = spmc_ep_dispatch_get(id);
+
+	if (ep == NULL) {
+		return NULL;
+	}
+
+	return ep->sp;
+}
+
 /*
  * Helper function to obtain the descriptor of the Hypervisor or OS kernel.
  * We assume that the first descriptor is reserved for this entity.
@@ -174,9 +240,15 @@ bool is_ffa_secure_id_valid(uint16_t partition_id)
 		return false;
 	}
 
-	/* Ensure we do not already have an SP context with this ID. */
-	if (spmc_get_sp_ctx(partition_id)) {
-		return false;
+	/*
+	 * Ensure we do not already have an SP context with this ID. This is
+	 * called while parsing the SP manifests, before the dispatch table is
+	 * populated, so check the descriptors directly.
+	 */
+	for (unsigned int i = 0U; i < SECURE_PARTITION_COUNT; i++) {
+		if (sp_desc[i].sp_id == partition_id) {
+			return false;
+		}
 	}
 
 	/* Ensure we don't clash with any Logical SP's. */
@@ -273,7 +345,7 @@ static uint64_t direct_req_smc_handler(uint32_t smc_fid,
 				       uint64_t flags)
 {
 	uint16_t dst_id = ffa_endpoint_destination(x1);
-	struct el3_lp_desc *el3_lp_descs;
+	struct spmc_ep_dispatch *ep;
 	struct secure_partition_desc *sp;
 	unsigned int idx;
 
@@ -283,15 +355,12 @@ static uint64_t direct_req_smc_handler(uint32_t smc_fid,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
 
-	el3_lp_descs = get_el3_lp_array();
+	ep = spmc_ep_dispatch_get(dst_id);
 
 	/* Check if the request is destined for a Logical Partition. */
-	for (unsigned int i = 0U; i < MAX_EL3_LP_DESCS_COUNT; i++) {
-		if (el3_lp_descs[i].sp_id == dst_id) {
-			return el3_lp_descs[i].direct_req(
-					smc_fid, secure_origin, x1, x2, x3, x4,
-					cookie, handle, flags);
-		}
+	if ((ep != NULL) && (ep->lp != NULL)) {
+		return ep->lp->direct_req(smc_fid, secure_origin, x1, x2, x3,
+					  x4, cookie, handle, flags);
 	}
 
 	/*
@@ -307,13 +376,13 @@ static uint64_t direct_req_smc_handler(uint32_t smc_fid,
 	}
 
 	/* Check if the SP ID is valid. */
-	sp = spmc_get_sp_ctx(dst_id);
-	if (sp == NULL) {
+	if (ep == NULL) {
 		VERBOSE("Direct request to unknown partition ID (0x%x).\n",
 			dst_id);
 		return spmc_ffa_error_return(handle,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
+	sp = ep->sp;
 
 	/*
 	 * Check that the target execution context is in a waiting state before
@@ -332,8 +401,15 @@ static uint64_t direct_req_smc_handler(uint32_t smc_fid,
 	 */
 	sp->ec[idx].rt_state = RT_STATE_RUNNING;
 	sp->ec[idx].rt_model = RT_MODEL_DIR_REQ;
-	return spmc_smc_return(smc_fid, secure_origin, x1, x2, x3, x4,
-			       handle, cookie, flags, dst_id);
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		RT_INSTR_ENTER_FFA_DIRECT_REQ,
+		PMF_NO_CACHE_MAINT);
+#endif
+
+	return spmd_smc_switch_state(smc_fid, secure_origin, x1, x2, x3, x4,
+				     handle);
 }
 
 /*******************************************************************************
@@ -410,8 +486,24 @@ static uint64_t direct_resp_smc_handler(uint32_t smc_fid,
 		panic();
 	}
 
-	return spmc_smc_return(smc_fid, secure_origin, x1, x2, x3, x4,
-			       handle, cookie, flags, dst_id);
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		RT_INSTR_EXIT_FFA_DIRECT_RESP,
+		PMF_NO_CACHE_MAINT);
+#endif
+
+	/*
+	 * An SP that has declared a static EL1 configuration in its manifest
+	 * has not changed the rest of its EL1 context since it was last saved.
+	 */
+	if (sp->static_el1_config) {
+		return spmd_smc_switch_state_volatile_el1(smc_fid, secure_origin,
+							  x1, x2, x3, x4,
+							  handle);
+	}
+
+	return spmd_smc_switch_state(smc_fid, secure_origin, x1, x2, x3, x4,
+				     handle);
 }
 
 /*******************************************************************************
@@ -1512,6 +1604,17 @@ static int sp_manifest_parse(void *sp_manifest, int offset,
 		sp->pwr_mgmt_msgs = config_32;
 	}
 
+	ret = fdt_read_uint32(sp_manifest, node,
+			      "static-el1-config", &config_32);
+	if (ret == 0) {
+		/*
+		 * Only an AArch64 S-EL1 SP is allowed to skip saving the
+		 * registers configuring its EL1 translation regime.
+		 */
+		sp->static_el1_config = (config_32 != 0U) &&
+			(sp->execution_state == SP_STATE_AARCH64);
+	}
+
 	ret = fdt_read_uint32(sp_manifest, node,
 			      "gp-register-num", &config_32);
 	if (ret != 0) {
@@ -1653,6 +1756,8 @@ static int32_t logical_sp_init(void)
 		}
 		VERBOSE("Logical SP (0x%x) Initialized\n",
 			      el3_lp_descs[i].sp_id);
+		spmc_ep_dispatch_add(el3_lp_descs[i].sp_id, &el3_lp_descs[i],
+				     NULL);
 	}
 
 	INFO("Logical Secure Partition init completed.\n");
@@ -1727,6 +1832,7 @@ static void initalize_sp_descs(void)
 		sp->mailbox.tx_buffer = NULL;
 		sp->mailbox.state = MAILBOX_STATE_EMPTY;
 		sp->secondary_ep = 0;
+		sp->static_el1_config = false;
 	}
 }
 
@@ -1804,6 +1910,14 @@ int32_t spmc_setup(void)
 		return ret;
 	}
 
+	/* Index the SPs by their endpoint ID. */
+	for (unsigned int i = 0U; i < SECURE_PARTITION_COUNT; i++) {
+		if (sp_desc[i].sp_id != INV_SP_ID) {
+			spmc_ep_dispatch_add(sp_desc[i].sp_id, NULL,
+					     &sp_desc[i]);
+		}
+	}
+
 	/* Register power management hooks with PSCI */
 	psci_register_spd_pm_hook(&spmc_pm);
 
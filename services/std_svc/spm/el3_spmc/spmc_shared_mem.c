@@ -56,6 +56,116 @@ static size_t spmc_shmem_obj_size(size_t desc_size)
 	return desc_size + offsetof(struct spmc_shmem_obj, desc);
 }
 
+/**
+ * spmc_shmem_obj_index_slot - Get the first index entry to probe for a handle.
+ * @handle:     Handle of the object.
+ *
+ * Handles are allocated sequentially, so their low bits spread them evenly.
+ *
+ * Return: Index of the entry in &struct spmc_shmem_obj_state.index.
+ */
+static size_t spmc_shmem_obj_index_slot(uint64_t handle)
+{
+	return (size_t)handle & (SPMC_SHMEM_INDEX_SIZE - 1U);
+}
+
+/**
+ * spmc_shmem_obj_index_find - Find the index entry of a handle.
+ * @state:      Global state.
+ * @handle:     Handle of the object.
+ *
+ * Return: Pointer to the entry of @handle, or to the free entry where it would
+ *         be inserted.
+ */
+static struct spmc_shmem_obj_index_entry *
+spmc_shmem_obj_index_find(struct spmc_shmem_obj_state *state, uint64_t handle)
+{
+	size_t slot = spmc_shmem_obj_index_slot(handle);
+
+	/* The index is never full, so a free entry will be found. */
+	while ((state->index[slot].offset != 0U) &&
+	       (state->index[slot].handle != handle)) {
+		slot = (slot + 1U) & (SPMC_SHMEM_INDEX_SIZE - 1U);
+	}
+
+	return &state->index[slot];
+}
+
+/**
+ * spmc_shmem_obj_index_add - Add an object to the handle index.
+ * @state:      Global state.
+ * @obj:        Object to index, with its final handle set.
+ *
+ * If @obj->desc.handle is already indexed, its entry is updated to point to
+ * @obj instead.
+ */
+static void spmc_shmem_obj_index_add(struct spmc_shmem_obj_state *state,
+				     struct spmc_shmem_obj *obj)
+{
+	struct spmc_shmem_obj_index_entry *entry;
+
+	entry = spmc_shmem_obj_index_find(state, obj->desc.handle);
+	if (entry->offset == 0U) {
+		if (state->index_count >= SPMC_SHMEM_INDEX_MAX_COUNT) {
+			state->index_overflow = true;
+			return;
+		}
+		entry->handle = obj->desc.handle;
+		state->index_count++;
+	}
+	entry->offset = ((uint8_t *)obj - state->data) + 1U;
+}
+
+/**
+ * spmc_shmem_obj_index_remove - Remove an object from the handle index.
+ * @state:      Global state.
+ * @obj:        Object about to be freed.
+ * @obj_size:   Size of @obj in the backing store.
+ *
+ * The entry of @obj is only removed if it points to @obj, as temporary copies
+ * of an object share its handle. Entries of the objects following @obj in the
+ * backing store are updated for them to be moved down by @obj_size.
+ */
+static void spmc_shmem_obj_index_remove(struct spmc_shmem_obj_state *state,
+					struct spmc_shmem_obj *obj,
+					size_t obj_size)
+{
+	struct spmc_shmem_obj_index_entry *entry;
+	size_t offset = ((uint8_t *)obj - state->data) + 1U;
+	size_t hole, slot, home;
+
+	entry = spmc_shmem_obj_index_find(state, obj->desc.handle);
+	if (entry->offset == offset) {
+		/*
+		 * Backward shift deletion: move up the following entries of
+		 * the cluster that may not be found anymore past the hole.
+		 */
+		hole = entry - state->index;
+		slot = hole;
+		for (;;) {
+			slot = (slot + 1U) & (SPMC_SHMEM_INDEX_SIZE - 1U);
+			if (state->index[slot].offset == 0U) {
+				break;
+			}
+			home = spmc_shmem_obj_index_slot(
+					state->index[slot].handle);
+			if (((slot - home) & (SPMC_SHMEM_INDEX_SIZE - 1U)) >=
+			    ((slot - hole) & (SPMC_SHMEM_INDEX_SIZE - 1U))) {
+				state->index[hole] = state->index[slot];
+				hole = slot;
+			}
+		}
+		state->index[hole].offset = 0U;
+		state->index_count--;
+	}
+
+	for (slot = 0U; slot < SPMC_SHMEM_INDEX_SIZE; slot++) {
+		if (state->index[slot].offset > offset) {
+			state->index[slot].offset -= obj_size;
+		}
+	}
+}
+
 /**
  * spmc_shmem_obj_alloc - Allocate struct spmc_shmem_obj.
  * @state:      Global state.
@@ -123,6 +233,8 @@ static void spmc_shmem_obj_free(struct spmc_shmem_obj_state *state,
 	uint8_t *shift_src = shift_dest + free_size;
 	size_t shift_size = state->allocated - (shift_src - state->data);
 
+	spmc_shmem_obj_index_remove(state, obj, free_size);
+
 	if (shift_size != 0U) {
 		memmove(shift_dest, shift_src, shift_size);
 	}
@@ -140,8 +252,19 @@ static void spmc_shmem_obj_free(struct spmc_shmem_obj_state *state,
 static struct spmc_shmem_obj *
 spmc_shmem_obj_lookup(struct spmc_shmem_obj_state *state, uint64_t handle)
 {
+	struct spmc_shmem_obj_index_entry *entry;
 	uint8_t *curr = state->data;
 
+	entry = spmc_shmem_obj_index_find(state, handle);
+	if (entry->offset != 0U) {
+		return (struct spmc_shmem_obj *)(state->data + entry->offset -
+						 1U);
+	}
+
+	if (!state->index_overflow) {
+		return NULL;
+	}
+
 	while (curr - state->data < state->allocated) {
 		struct spmc_shmem_obj *obj = (struct spmc_shmem_obj *)curr;
 
@@ -936,6 +1059,7 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 		/* First fragment, descriptor header has been copied */
 		obj->desc.handle = spmc_shmem_obj_state.next_handle++;
 		obj->desc.flags |= mtd_flag;
+		spmc_shmem_obj_index_add(&spmc_shmem_obj_state, obj);
 	}
 
 	obj->desc_filled += fragment_length;
@@ -1058,6 +1182,7 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 		 * and continue our checks with the new v1.1 descriptor.
 		 */
 		mem_handle = obj->desc.handle;
+		spmc_shmem_obj_index_add(&spmc_shmem_obj_state, v1_1_obj);
 		spmc_shmem_obj_free(&spmc_shmem_obj_state, obj);
 		obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, mem_handle);
 		if (obj == NULL) {
@@ -31,12 +31,41 @@ struct ffa_mem_relinquish_descriptor {
 CASSERT(sizeof(struct ffa_mem_relinquish_descriptor) == 16,
 	assert_ffa_mem_relinquish_descriptor_size_mismatch);
 
+/*
+ * Number of entries of the handle index of the shared memory objects. Must be
+ * a power of two. Objects beyond 3/4 of it are still found, but by walking the
+ * backing store.
+ */
+#ifndef PLAT_SPMC_SHMEM_INDEX_SIZE
+#define SPMC_SHMEM_INDEX_SIZE		U(256)
+#else
+#define SPMC_SHMEM_INDEX_SIZE		PLAT_SPMC_SHMEM_INDEX_SIZE
+#endif
+#define SPMC_SHMEM_INDEX_MAX_COUNT	((SPMC_SHMEM_INDEX_SIZE * 3U) / 4U)
+
+CASSERT((SPMC_SHMEM_INDEX_SIZE & (SPMC_SHMEM_INDEX_SIZE - 1U)) == 0U,
+	assert_spmc_shmem_index_size_not_power_of_two);
+
+/**
+ * struct spmc_shmem_obj_index_entry - Entry of the handle index.
+ * @handle:         Handle of the indexed object.
+ * @offset:         Offset of the object in the backing store plus one, or 0 if
+ *                  the entry is free.
+ */
+struct spmc_shmem_obj_index_entry {
+	uint64_t handle;
+	size_t offset;
+};
+
 /**
  * struct spmc_shmem_obj_state - Global state.
  * @data:           Backing store for spmc_shmem_obj objects.
  * @data_size:      The size allocated for the backing store.
  * @allocated:      Number of bytes allocated in @data.
  * @next_handle:    Handle used for next allocated object.
+ * @index:          Open-addressed hash table of the objects, by handle.
+ * @index_count:    Number of used entries in @index.
+ * @index_overflow: Some objects could not be added to @index.
  * @lock:           Lock protecting all state in this file.
  */
 struct spmc_shmem_obj_state {
@@ -44,6 +73,9 @@ struct spmc_shmem_obj_state {
 	size_t data_size;
 	size_t allocated;
 	uint64_t next_handle;
+	struct spmc_shmem_obj_index_entry index[SPMC_SHMEM_INDEX_SIZE];
+	size_t index_count;
+	bool index_overflow;
 	spinlock_t lock;
 };
 
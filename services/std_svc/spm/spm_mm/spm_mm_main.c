@@ -7,6 +7,7 @@
 #include <arch_helpers.h>
 #include <assert.h>
 #include <errno.h>
+#include <inttypes.h>
 
 #include <bl31/bl31.h>
 #include <bl31/ehf.h>
@@ -26,9 +27,25 @@
 #include "spm_mm_private.h"
 
 /*******************************************************************************
- * Secure Partition context information.
+ * Secure Partition context information. The first context is the one the
+ * partition is initialised with on the primary CPU. If the partition registers
+ * a secondary entry point during its initialisation, each other CPU described
+ * in its boot information gets its own context. Otherwise, all CPUs share the
+ * first context.
  ******************************************************************************/
-static sp_context_t sp_ctx;
+static sp_context_t sp_ctx[SPM_MM_CTX_COUNT];
+static unsigned int sp_ctx_count;
+
+#if SPM_MM_MULTI_THREADED
+/* Secondary entry point registered by the partition, or 0. */
+static uintptr_t sp_secondary_ep;
+#endif
+
+/* Context used by each CPU to handle MM_COMMUNICATE calls. */
+static sp_context_t *sp_ctx_by_core[PLATFORM_CORE_COUNT];
+
+/* Context each CPU is currently running, if any. */
+static sp_context_t *sp_ctx_running[PLATFORM_CORE_COUNT];
 
 /*******************************************************************************
  * Set state of a Secure Partition context.
@@ -93,6 +110,7 @@ static uint64_t spm_sp_synchronous_entry(sp_context_t *ctx)
 	assert(ctx != NULL);
 
 	/* Assign the context of the SP to this CPU */
+	sp_ctx_running[plat_my_core_pos()] = ctx;
 	cm_set_context(&(ctx->cpu_ctx), SECURE);
 
 	/* Restore the context assigned above */
@@ -109,16 +127,30 @@ static uint64_t spm_sp_synchronous_entry(sp_context_t *ctx)
 	/* Save secure state */
 	cm_el1_sysregs_context_save(SECURE);
 
+	sp_ctx_running[plat_my_core_pos()] = NULL;
+
 	return rc;
 }
 
+/*******************************************************************************
+ * Return the Secure Partition context being run by the calling CPU.
+ ******************************************************************************/
+static sp_context_t *spm_sp_running_ctx(void)
+{
+	sp_context_t *ctx = sp_ctx_running[plat_my_core_pos()];
+
+	assert(ctx != NULL);
+
+	return ctx;
+}
+
 /*******************************************************************************
  * This function returns to the place where spm_sp_synchronous_entry() was
  * called originally.
  ******************************************************************************/
 __dead2 static void spm_sp_synchronous_exit(uint64_t rc)
 {
-	sp_context_t *ctx = &sp_ctx;
+	sp_context_t *ctx = spm_sp_running_ctx();
 
 	/*
 	 * The SPM must have initiated the original request through a
@@ -130,6 +162,86 @@ __dead2 static void spm_sp_synchronous_exit(uint64_t rc)
 	panic();
 }
 
+#if SPM_MM_MULTI_THREADED
+/*******************************************************************************
+ * Register the entry point the partition is entered at on each secondary CPU
+ * to initialise its execution context. It is only accepted while the partition
+ * is being initialised on the primary CPU, and must lie within its image.
+ ******************************************************************************/
+static int32_t spm_sp_secondary_ep_register(const sp_context_t *ctx,
+					    uintptr_t ep)
+{
+	const spm_mm_boot_info_t *sp_boot_info =
+			plat_get_secure_partition_boot_info(NULL);
+
+	if ((ctx != &sp_ctx[0]) || (ctx->state != SP_STATE_RESET)) {
+		WARN("MM_SP_SECONDARY_EP_REGISTER_AARCH64 is available at boot time only\n");
+		return SPM_MM_NOT_SUPPORTED;
+	}
+
+	if ((ep < sp_boot_info->sp_image_base) ||
+	    (ep >= (sp_boot_info->sp_image_base +
+		    sp_boot_info->sp_image_size)) ||
+	    !is_aligned(ep, 4U)) {
+		return SPM_MM_INVALID_PARAMETER;
+	}
+
+	sp_secondary_ep = ep;
+
+	return SPM_MM_SUCCESS;
+}
+
+/*******************************************************************************
+ * Give each CPU described in the boot information of the partition, other than
+ * the primary one, its own execution context. The contexts are copies of the
+ * primary one that start at the registered secondary entry point. They are left
+ * in the reset state and only entered on their CPU the first time it is used.
+ ******************************************************************************/
+static void spm_sp_setup_secondaries(const sp_context_t *primary_ctx)
+{
+	const spm_mm_boot_info_t *sp_boot_info =
+			plat_get_secure_partition_boot_info(NULL);
+	unsigned int core_pos;
+	sp_context_t *ctx;
+
+	for (unsigned int i = 0U; i < sp_boot_info->num_cpus; i++) {
+		int pos = plat_core_pos_by_mpidr(sp_boot_info->mp_info[i].mpidr);
+
+		/*
+		 * A CPU unknown to the platform keeps sharing the primary
+		 * context rather than indexing out of bounds.
+		 */
+		if (pos < 0) {
+			WARN("Secure Partition CPU 0x%" PRIx64 " is invalid, ignoring it.\n",
+			     sp_boot_info->mp_info[i].mpidr);
+			continue;
+		}
+
+		core_pos = (unsigned int)pos;
+		assert(core_pos < PLATFORM_CORE_COUNT);
+
+		/* Only give each secondary CPU one context. */
+		if (sp_ctx_by_core[core_pos] != primary_ctx) {
+			continue;
+		}
+		if (core_pos == plat_my_core_pos()) {
+			continue;
+		}
+
+		assert(sp_ctx_count < SPM_MM_CTX_COUNT);
+		ctx = &sp_ctx[sp_ctx_count];
+
+		spm_sp_setup_secondary(primary_ctx, ctx, i, sp_secondary_ep);
+		ctx->state = SP_STATE_RESET;
+
+		sp_ctx_by_core[core_pos] = ctx;
+		sp_ctx_count++;
+	}
+
+	INFO("Secure Partition uses %u execution contexts.\n", sp_ctx_count);
+}
+#endif /* SPM_MM_MULTI_THREADED */
+
 /*******************************************************************************
  * Jump to each Secure Partition for the first time.
  ******************************************************************************/
@@ -140,7 +252,7 @@ static int32_t spm_init(void)
 
 	INFO("Secure Partition init...\n");
 
-	ctx = &sp_ctx;
+	ctx = &sp_ctx[0];
 
 	ctx->state = SP_STATE_RESET;
 
@@ -149,6 +261,12 @@ static int32_t spm_init(void)
 
 	ctx->state = SP_STATE_IDLE;
 
+#if SPM_MM_MULTI_THREADED
+	if ((rc == 0U) && (sp_secondary_ep != 0U)) {
+		spm_sp_setup_secondaries(ctx);
+	}
+#endif
+
 	INFO("Secure Partition initialized.\n");
 
 	return !rc;
@@ -159,6 +277,7 @@ static int32_t spm_init(void)
  ******************************************************************************/
 int32_t spm_mm_setup(void)
 {
+	unsigned int core_pos;
 	sp_context_t *ctx;
 
 	/* Disable MMU at EL1 (initialized by BL2) */
@@ -167,12 +286,18 @@ int32_t spm_mm_setup(void)
 	/* Initialize context of the SP */
 	INFO("Secure Partition context setup start...\n");
 
-	ctx = &sp_ctx;
+	ctx = &sp_ctx[0];
 
 	/* Assign translation tables context. */
 	ctx->xlat_ctx_handle = spm_get_sp_xlat_context();
 
 	spm_sp_setup(ctx);
+	sp_ctx_count = 1U;
+
+	/* All CPUs share the primary context until secondaries are set up. */
+	for (core_pos = 0U; core_pos < PLATFORM_CORE_COUNT; core_pos++) {
+		sp_ctx_by_core[core_pos] = ctx;
+	}
 
 	/* Register init function for deferred init.  */
 	bl31_register_bl32_init(&spm_init);
@@ -188,7 +313,7 @@ int32_t spm_mm_setup(void)
 uint64_t spm_mm_sp_call(uint32_t smc_fid, uint64_t x1, uint64_t x2, uint64_t x3)
 {
 	uint64_t rc;
-	sp_context_t *sp_ptr = &sp_ctx;
+	sp_context_t *sp_ptr = sp_ctx_by_core[plat_my_core_pos()];
 
 #if CTX_INCLUDE_FPREGS
 	/*
@@ -198,6 +323,26 @@ uint64_t spm_mm_sp_call(uint32_t smc_fid, uint64_t x1, uint64_t x2, uint64_t x3)
 	fpregs_context_save(get_fpregs_ctx(cm_get_context(NON_SECURE)));
 #endif
 
+#if SPM_MM_MULTI_THREADED
+	/*
+	 * A secondary context is only used by its own CPU. The first time it
+	 * is used, enter the partition at its secondary entry point so that it
+	 * initialises the context. Fall back to the primary context if that
+	 * fails.
+	 */
+	if (sp_ptr->state == SP_STATE_RESET) {
+		rc = spm_sp_synchronous_entry(sp_ptr);
+		if (rc == 0U) {
+			sp_state_set(sp_ptr, SP_STATE_IDLE);
+		} else {
+			WARN("Secure Partition secondary init failed (%" PRIu64 "), using the primary context.\n",
+			     rc);
+			sp_ptr = &sp_ctx[0];
+			sp_ctx_by_core[plat_my_core_pos()] = sp_ptr;
+		}
+	}
+#endif
+
 	/* Wait until the Secure Partition is idle and set it to busy. */
 	sp_state_wait_switch(sp_ptr, SP_STATE_IDLE, SP_STATE_BUSY);
 
@@ -254,7 +399,10 @@ static uint64_t mm_communicate(uint32_t smc_fid, uint64_t mm_cookie,
 	/*
 	 * The current secure partition design mandates
 	 * - at any point, only a single core can be
-	 *   executing in the secure partiton.
+	 *   executing in a given secure partition
+	 *   execution context. Unless the partition has
+	 *   registered a secondary entry point, all cores
+	 *   share one context.
 	 * - a core cannot be preempted by an interrupt
 	 *   while executing in secure partition.
 	 * Raise the running priority of the core to the
@@ -296,6 +444,7 @@ uint64_t spm_mm_smc_handler(uint32_t smc_fid,
 			 uint64_t flags)
 {
 	unsigned int ns;
+	sp_context_t *ctx;
 
 	/* Determine which security state this SMC originated from */
 	ns = is_caller_non_secure(flags);
@@ -306,6 +455,8 @@ uint64_t spm_mm_smc_handler(uint32_t smc_fid,
 
 		assert(handle == cm_get_context(SECURE));
 
+		ctx = spm_sp_running_ctx();
+
 		/* Make next ERET jump to S-EL0 instead of S-EL1. */
 		cm_set_elr_spsr_el3(SECURE, read_elr_el1(), read_spsr_el1());
 
@@ -320,24 +471,36 @@ uint64_t spm_mm_smc_handler(uint32_t smc_fid,
 		case MM_SP_MEMORY_ATTRIBUTES_GET_AARCH64:
 			INFO("Received MM_SP_MEMORY_ATTRIBUTES_GET_AARCH64 SMC\n");
 
-			if (sp_ctx.state != SP_STATE_RESET) {
+			if ((ctx != &sp_ctx[0]) ||
+			    (ctx->state != SP_STATE_RESET)) {
 				WARN("MM_SP_MEMORY_ATTRIBUTES_GET_AARCH64 is available at boot time only\n");
 				SMC_RET1(handle, SPM_MM_NOT_SUPPORTED);
 			}
 			SMC_RET1(handle,
 				 spm_memory_attributes_get_smc_handler(
-					 &sp_ctx, x1));
+					 ctx, x1));
 
 		case MM_SP_MEMORY_ATTRIBUTES_SET_AARCH64:
 			INFO("Received MM_SP_MEMORY_ATTRIBUTES_SET_AARCH64 SMC\n");
 
-			if (sp_ctx.state != SP_STATE_RESET) {
+			if ((ctx != &sp_ctx[0]) ||
+			    (ctx->state != SP_STATE_RESET)) {
 				WARN("MM_SP_MEMORY_ATTRIBUTES_SET_AARCH64 is available at boot time only\n");
 				SMC_RET1(handle, SPM_MM_NOT_SUPPORTED);
 			}
 			SMC_RET1(handle,
 				 spm_memory_attributes_set_smc_handler(
-					&sp_ctx, x1, x2, x3));
+					ctx, x1, x2, x3));
+
+		case MM_SP_SECONDARY_EP_REGISTER_AARCH64:
+			INFO("Received MM_SP_SECONDARY_EP_REGISTER_AARCH64 SMC\n");
+
+#if SPM_MM_MULTI_THREADED
+			SMC_RET1(handle,
+				 spm_sp_secondary_ep_register(ctx, x1));
+#else
+			SMC_RET1(handle, SPM_MM_NOT_SUPPORTED);
+#endif
 		default:
 			break;
 		}
@@ -37,6 +37,18 @@
 #include <lib/spinlock.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 
+#include <platform_def.h>
+
+/*
+ * Number of execution contexts allocated for the Secure Partition. Only a
+ * partition that registers a secondary entry point makes use of more than one.
+ */
+#if SPM_MM_MULTI_THREADED
+#define SPM_MM_CTX_COUNT	PLATFORM_CORE_COUNT
+#else
+#define SPM_MM_CTX_COUNT	1
+#endif
+
 typedef enum sp_state {
 	SP_STATE_RESET = 0,
 	SP_STATE_IDLE,
@@ -54,6 +66,9 @@ typedef struct sp_context {
 
 
 void spm_sp_setup(sp_context_t *sp_ctx);
+void spm_sp_setup_secondary(const sp_context_t *primary_ctx,
+			    sp_context_t *sp_ctx, unsigned int cpu_index,
+			    uintptr_t entrypoint);
 
 xlat_ctx_t *spm_get_sp_xlat_context(void);
 
@@ -13,6 +13,7 @@
 #include <context.h>
 #include <common/debug.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 #include <platform_def.h>
 #include <plat/common/common_def.h>
@@ -258,3 +259,39 @@ void spm_sp_setup(sp_context_t *sp_ctx)
 			sp_mp_info[index].flags |= MP_INFO_FLAG_PRIMARY_CPU;
 	}
 }
+
+#if SPM_MM_MULTI_THREADED
+/*
+ * Setup the execution context used by the CPU at index cpu_index of the MP
+ * information of the Secure Partition. It shares the EL1 configuration and the
+ * translation tables of the primary context, and enters the partition at its
+ * secondary entry point with its own stack.
+ *
+ * X0: Index of the CPU in the MP information.
+ *
+ * X1 to X7 = 0
+ */
+void spm_sp_setup_secondary(const sp_context_t *primary_ctx,
+			    sp_context_t *sp_ctx, unsigned int cpu_index,
+			    uintptr_t entrypoint)
+{
+	const spm_mm_boot_info_t *sp_boot_info =
+			plat_get_secure_partition_boot_info(NULL);
+	cpu_context_t *ctx = &(sp_ctx->cpu_ctx);
+
+	assert(cpu_index < sp_boot_info->num_cpus);
+
+	memcpy(ctx, &(primary_ctx->cpu_ctx), sizeof(cpu_context_t));
+	sp_ctx->xlat_ctx_handle = primary_ctx->xlat_ctx_handle;
+
+	zeromem(get_gpregs_ctx(ctx), sizeof(gp_regs_t));
+	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X0, cpu_index);
+	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_SP_EL0,
+		      sp_boot_info->sp_stack_base +
+		      ((cpu_index + 1U) * sp_boot_info->sp_pcpu_stack_size));
+
+	write_ctx_reg(get_el3state_ctx(ctx), CTX_ELR_EL3, entrypoint);
+	write_ctx_reg(get_el3state_ctx(ctx), CTX_SPSR_EL3,
+		      SPSR_64(MODE_EL0, MODE_SP_EL0, DISABLE_ALL_EXCEPTIONS));
+}
+#endif /* SPM_MM_MULTI_THREADED */
@@ -17,6 +17,8 @@
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/pmf/pmf.h>
+#include <lib/runtime_instr.h>
 #include <lib/smccc.h>
 #include <lib/spinlock.h>
 #include <lib/utils.h>
@@ -436,27 +438,49 @@ int spmd_setup(void)
 }
 
 /*******************************************************************************
- * Forward FF-A SMCs to the other security state.
+ * Switch to the other security state, forwarding the FF-A SMC arguments. If
+ * 'el1_volatile_only' is set, only the volatile part of the EL1 context of the
+ * incoming security state is saved.
  ******************************************************************************/
-uint64_t spmd_smc_switch_state(uint32_t smc_fid,
-			       bool secure_origin,
-			       uint64_t x1,
-			       uint64_t x2,
-			       uint64_t x3,
-			       uint64_t x4,
-			       void *handle)
+static uint64_t spmd_smc_switch_state_common(uint32_t smc_fid,
+					     bool secure_origin,
+					     bool el1_volatile_only,
+					     uint64_t x1,
+					     uint64_t x2,
+					     uint64_t x3,
+					     uint64_t x4,
+					     void *handle)
 {
 	unsigned int secure_state_in = (secure_origin) ? SECURE : NON_SECURE;
 	unsigned int secure_state_out = (!secure_origin) ? SECURE : NON_SECURE;
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		RT_INSTR_ENTER_WORLD_SWITCH,
+		PMF_NO_CACHE_MAINT);
+#endif
+
 	/* Save incoming security state */
 #if SPMD_SPM_AT_SEL2
 	if (secure_state_in == NON_SECURE) {
-		cm_el1_sysregs_context_save(secure_state_in);
+		if (el1_volatile_only) {
+			cm_el1_sysregs_context_save_volatile(secure_state_in);
+		} else {
+			cm_el1_sysregs_context_save(secure_state_in);
+		}
 	}
+#if CTX_EL2_REGS_LAZY_SWITCH
+	/* Save and restore the EL2 state in one go. */
+	cm_el2_sysregs_context_switch(secure_state_in, secure_state_out);
+#else
 	cm_el2_sysregs_context_save(secure_state_in);
+#endif
 #else
-	cm_el1_sysregs_context_save(secure_state_in);
+	if (el1_volatile_only) {
+		cm_el1_sysregs_context_save_volatile(secure_state_in);
+	} else {
+		cm_el1_sysregs_context_save(secure_state_in);
+	}
 #endif
 
 	/* Restore outgoing security state */
@@ -464,18 +488,58 @@ uint64_t spmd_smc_switch_state(uint32_t smc_fid,
 	if (secure_state_out == NON_SECURE) {
 		cm_el1_sysregs_context_restore(secure_state_out);
 	}
+#if !CTX_EL2_REGS_LAZY_SWITCH
 	cm_el2_sysregs_context_restore(secure_state_out);
+#endif
 #else
 	cm_el1_sysregs_context_restore(secure_state_out);
 #endif
 	cm_set_next_eret_context(secure_state_out);
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		RT_INSTR_EXIT_WORLD_SWITCH,
+		PMF_NO_CACHE_MAINT);
+#endif
+
 	SMC_RET8(cm_get_context(secure_state_out), smc_fid, x1, x2, x3, x4,
 			SMC_GET_GP(handle, CTX_GPREG_X5),
 			SMC_GET_GP(handle, CTX_GPREG_X6),
 			SMC_GET_GP(handle, CTX_GPREG_X7));
 }
 
+/*******************************************************************************
+ * Forward FF-A SMCs to the other security state.
+ ******************************************************************************/
+uint64_t spmd_smc_switch_state(uint32_t smc_fid,
+			       bool secure_origin,
+			       uint64_t x1,
+			       uint64_t x2,
+			       uint64_t x3,
+			       uint64_t x4,
+			       void *handle)
+{
+	return spmd_smc_switch_state_common(smc_fid, secure_origin, false,
+					    x1, x2, x3, x4, handle);
+}
+
+/*******************************************************************************
+ * Forward FF-A SMCs to the other security state, only saving the volatile part
+ * of the EL1 context of the incoming security state. The caller must know that
+ * the rest of that context has not changed since it was last saved.
+ ******************************************************************************/
+uint64_t spmd_smc_switch_state_volatile_el1(uint32_t smc_fid,
+					    bool secure_origin,
+					    uint64_t x1,
+					    uint64_t x2,
+					    uint64_t x3,
+					    uint64_t x4,
+					    void *handle)
+{
+	return spmd_smc_switch_state_common(smc_fid, secure_origin, true,
+					    x1, x2, x3, x4, handle);
+}
+
 /*******************************************************************************
  * Forward SMCs to the other security state.
  ******************************************************************************/
@@ -127,6 +127,10 @@ static uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 		    RT_INSTR_ENTER_PSCI,
 		    PMF_CACHE_MAINT,
 		    get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]));
+		PMF_WRITE_TRACE_EVENT(rt_trace_svc,
+		    RT_INSTR_ENTER_PSCI,
+		    smc_fid,
+		    get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]));
 #endif
 
 		ret = psci_smc_handler(smc_fid, x1, x2, x3, x4,
@@ -136,6 +140,9 @@ static uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
 		    RT_INSTR_EXIT_PSCI,
 		    PMF_NO_CACHE_MAINT);
+		PMF_TRACE_EVENT(rt_trace_svc,
+		    RT_INSTR_EXIT_PSCI,
+		    smc_fid);
 #endif
 
 		SMC_RET1(handle, ret);
@@ -236,3 +243,9 @@ DECLARE_RT_SVC(
 		std_svc_setup,
 		std_svc_smc_handler
 );
+
+/*
+ * Calls that only return a value are served on the fast path, without going
+ * through the runtime service dispatch.
+ */
+DECLARE_RT_SVC_FAST(psci_version, PSCI_VERSION, std_svc_smc_handler);
@@ -7,34 +7,74 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
+
+#include <lib/cassert.h>
 #include <lib/spinlock.h>
 #include <plat/common/plat_trng.h>
+#include <plat/common/platform.h>
+#include <platform_def.h>
+
+#include "trng_entropy_pool.h"
 
 /*
  * # Entropy pool
+ * A pool is a ring of words of entropy. Its valid bits start at bit_index and
+ * are bit_size long. Entropy is always added a whole word at a time, so the
+ * first free bit is always at the start of a word.
+ */
+struct trng_pool {
+	uint64_t *entropy;
+	uint32_t words;
+	/* index in bits of the first bit of usable entropy */
+	uint32_t bit_index;
+	/* then number of valid bits in the entropy pool */
+	uint32_t bit_size;
+};
+
+#define BITS_PER_WORD		(sizeof(uint64_t) * 8)
+#define BITS_IN_POOL(p)		((p)->words * BITS_PER_WORD)
+#define ENTROPY_MIN_WORD(p)	((p)->bit_index / BITS_PER_WORD)
+#define ENTROPY_FREE_BIT(p)	((p)->bit_size + (p)->bit_index)
+#define _ENTROPY_FREE_WORD(p)	(ENTROPY_FREE_BIT(p) / BITS_PER_WORD)
+#define ENTROPY_FREE_INDEX(p)	(_ENTROPY_FREE_WORD(p) % (p)->words)
+/* ENTROPY_WORD_INDEX(0) includes leftover bits in the lower bits */
+#define ENTROPY_WORD_INDEX(p, i) ((ENTROPY_MIN_WORD(p) + (i)) % (p)->words)
+
+/*
  * Note that the TRNG Firmware interface can request up to 192 bits of entropy
- * in a single call or three 64bit words per call. We have 4 words in the pool
- * so that when we have 1-63 bits in the pool, and we have a request for
+ * in a single call or three 64bit words per call. We have 4 words in the global
+ * pool so that when we have 1-63 bits in the pool, and we have a request for
  * 192 bits of entropy, we don't have to throw out the leftover 1-63 bits of
  * entropy.
  */
 #define WORDS_IN_POOL	(4)
 static uint64_t entropy[WORDS_IN_POOL];
-/* index in bits of the first bit of usable entropy */
-static uint32_t entropy_bit_index;
-/* then number of valid bits in the entropy pool */
-static uint32_t entropy_bit_size;
+static struct trng_pool trng_pool = {
+	.entropy = entropy,
+	.words = WORDS_IN_POOL,
+};
 
 static spinlock_t trng_pool_lock;
 
-#define BITS_PER_WORD		(sizeof(entropy[0]) * 8)
-#define BITS_IN_POOL		(WORDS_IN_POOL * BITS_PER_WORD)
-#define ENTROPY_MIN_WORD	(entropy_bit_index / BITS_PER_WORD)
-#define ENTROPY_FREE_BIT	(entropy_bit_size + entropy_bit_index)
-#define _ENTROPY_FREE_WORD	(ENTROPY_FREE_BIT / BITS_PER_WORD)
-#define ENTROPY_FREE_INDEX	(_ENTROPY_FREE_WORD % WORDS_IN_POOL)
-/* ENTROPY_WORD_INDEX(0) includes leftover bits in the lower bits */
-#define ENTROPY_WORD_INDEX(i)	((ENTROPY_MIN_WORD + i) % WORDS_IN_POOL)
+/*
+ * Each CPU serves its requests from its own pool, only accessed by that CPU, and
+ * tops it up from the global pool a batch of words at a time. This way, most
+ * requests do not need to take trng_pool_lock. A CPU pool must be able to hold
+ * as much entropy as the global pool for no leftover bits to be lost.
+ */
+#ifndef PLAT_TRNG_CPU_POOL_WORDS
+#define TRNG_CPU_POOL_WORDS	(8)
+#else
+#define TRNG_CPU_POOL_WORDS	PLAT_TRNG_CPU_POOL_WORDS
+#endif
+
+CASSERT(TRNG_CPU_POOL_WORDS >= WORDS_IN_POOL,
+	assert_trng_cpu_pool_smaller_than_global_pool);
+
+static struct trng_cpu_pool {
+	uint64_t entropy[TRNG_CPU_POOL_WORDS];
+	struct trng_pool pool;
+} __aligned(CACHE_WRITEBACK_GRANULE) trng_cpu_pools[PLATFORM_CORE_COUNT];
 
 /*
  * Fill the entropy pool until we have at least as many bits as requested.
@@ -42,14 +82,15 @@ static spinlock_t trng_pool_lock;
  * of entropy and the pool could not be filled.
  * Assumes locks are taken.
  */
-static bool trng_fill_entropy(uint32_t nbits)
+static bool trng_fill_entropy(struct trng_pool *pool, uint32_t nbits)
 {
-	while (nbits > entropy_bit_size) {
-		bool valid = plat_get_entropy(&entropy[ENTROPY_FREE_INDEX]);
+	while (nbits > pool->bit_size) {
+		bool valid = plat_get_entropy(
+				&pool->entropy[ENTROPY_FREE_INDEX(pool)]);
 
 		if (valid) {
-			entropy_bit_size += BITS_PER_WORD;
-			assert(entropy_bit_size <= BITS_IN_POOL);
+			pool->bit_size += BITS_PER_WORD;
+			assert(pool->bit_size <= BITS_IN_POOL(pool));
 		} else {
 			return false;
 		}
@@ -58,23 +99,17 @@ static bool trng_fill_entropy(uint32_t nbits)
 }
 
 /*
- * Pack entropy into the out buffer, filling and taking locks as needed.
- * Returns true on success, false on failure.
+ * Take nbits of entropy out of the pool and pack them into the out buffer.
+ * The pool must hold at least nbits of entropy.
  *
  * Note: out must have enough space for nbits of entropy
  */
-bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
+static void trng_take_entropy(struct trng_pool *pool, uint32_t nbits,
+			      uint64_t *out)
 {
-	bool ret = true;
-
-	spin_lock(&trng_pool_lock);
-
-	if (!trng_fill_entropy(nbits)) {
-		ret = false;
-		goto out;
-	}
+	assert(nbits <= pool->bit_size);
 
-	const unsigned int rshift = entropy_bit_index % BITS_PER_WORD;
+	const unsigned int rshift = pool->bit_index % BITS_PER_WORD;
 	const unsigned int lshift = BITS_PER_WORD - rshift;
 	const int to_fill = ((nbits + BITS_PER_WORD - 1) / BITS_PER_WORD);
 	int word_i;
@@ -112,7 +147,8 @@ bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
 		 *                  [e,e,e,e,e,e,e,e]
 		 */
 		out[word_i] = 0;
-		out[word_i] |= entropy[ENTROPY_WORD_INDEX(word_i)] >> rshift;
+		out[word_i] |= pool->entropy[ENTROPY_WORD_INDEX(pool, word_i)]
+			>> rshift;
 
 		/*
 		 * Note that a shift of 64 bits is treated as a shift of 0 bits.
@@ -121,30 +157,105 @@ bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
 		 * the `|=` operation.
 		 */
 		if (lshift != BITS_PER_WORD) {
-			out[word_i] |= entropy[ENTROPY_WORD_INDEX(word_i + 1)]
+			out[word_i] |=
+				pool->entropy[ENTROPY_WORD_INDEX(pool, word_i + 1)]
 				<< lshift;
 		}
 	}
-	const uint64_t mask = ~0ULL >> (BITS_PER_WORD - (nbits % BITS_PER_WORD));
 
-	out[to_fill - 1] &= mask;
+	/* Mask off the bits beyond nbits in the last word, if any */
+	if ((nbits % BITS_PER_WORD) != 0U) {
+		const uint64_t mask =
+			~0ULL >> (BITS_PER_WORD - (nbits % BITS_PER_WORD));
+
+		out[to_fill - 1] &= mask;
+	}
+
+	pool->bit_index = (pool->bit_index + nbits) % BITS_IN_POOL(pool);
+	pool->bit_size -= nbits;
+}
+
+/*
+ * Top up a CPU pool with whole words from the global pool, filling the latter
+ * from the platform entropy source as needed. trng_pool_lock is only taken
+ * once per batch. Stops early if the entropy source runs out.
+ */
+static void trng_refill_cpu_pool(struct trng_pool *cpu_pool)
+{
+	spin_lock(&trng_pool_lock);
 
-	entropy_bit_index = (entropy_bit_index + nbits) % BITS_IN_POOL;
-	entropy_bit_size -= nbits;
+	while ((BITS_IN_POOL(cpu_pool) - cpu_pool->bit_size) >= BITS_PER_WORD) {
+		if (!trng_fill_entropy(&trng_pool, BITS_PER_WORD)) {
+			break;
+		}
+
+		trng_take_entropy(&trng_pool, BITS_PER_WORD,
+				  &cpu_pool->entropy[ENTROPY_FREE_INDEX(cpu_pool)]);
+		cpu_pool->bit_size += BITS_PER_WORD;
+	}
 
-out:
 	spin_unlock(&trng_pool_lock);
+}
+
+/*
+ * Pack entropy into the out buffer, refilling the pool of the calling CPU from
+ * the global pool as needed. Returns true on success, false on failure.
+ *
+ * Note: out must have enough space for nbits of entropy
+ */
+bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
+{
+	struct trng_pool *cpu_pool = &trng_cpu_pools[plat_my_core_pos()].pool;
+
+	if (nbits > cpu_pool->bit_size) {
+		trng_refill_cpu_pool(cpu_pool);
+
+		if (nbits > cpu_pool->bit_size) {
+			return false;
+		}
+	}
 
-	return ret;
+	trng_take_entropy(cpu_pool, nbits, out);
+
+	return true;
+}
+
+/*
+ * Top up the pool of the calling CPU ahead of TRNG calls. This is meant to be
+ * called by the platform when the CPU is otherwise idle, e.g. from an EL3
+ * interrupt handler registered with the EHF or triggered by a timer, so that
+ * TRNG calls do not have to wait for the entropy source. It must not preempt
+ * a TRNG call on the same CPU, which holds as EL3 runs with interrupts masked.
+ */
+void trng_entropy_pool_refill(void)
+{
+	struct trng_pool *cpu_pool = &trng_cpu_pools[plat_my_core_pos()].pool;
+
+	if (cpu_pool->bit_size < BITS_IN_POOL(cpu_pool)) {
+		trng_refill_cpu_pool(cpu_pool);
+	}
 }
 
 void trng_entropy_pool_setup(void)
 {
+	unsigned int cpu;
 	int i;
 
 	for (i = 0; i < WORDS_IN_POOL; i++) {
 		entropy[i] = 0;
 	}
-	entropy_bit_index = 0;
-	entropy_bit_size = 0;
+	trng_pool.bit_index = 0;
+	trng_pool.bit_size = 0;
+
+	for (cpu = 0U; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		struct trng_cpu_pool *cpu_pool = &trng_cpu_pools[cpu];
+
+		for (i = 0; i < TRNG_CPU_POOL_WORDS; i++) {
+			cpu_pool->entropy[i] = 0;
+		}
+		cpu_pool->pool.entropy = cpu_pool->entropy;
+		cpu_pool->pool.words = TRNG_CPU_POOL_WORDS;
+		cpu_pool->pool.bit_index = 0;
+		cpu_pool->pool.bit_size = 0;
+	}
 }
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2022, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <openssl/sha.h>
+
+/*
+ * The manifest records what each certificate was last generated from, so that
+ * certificates whose inputs did not change are not signed again. For each
+ * certificate, it holds a fingerprint of everything that goes into it: the
+ * image digests, counters, public keys and the issuer certificate. The images
+ * are hashed on every run, so their digests are always current.
+ */
+#define MANIFEST_FP_LEN			SHA256_DIGEST_LENGTH
+
+/* Exported API */
+int manifest_load(const char *fn);
+int manifest_save(const char *fn);
+int manifest_cert_unchanged(const char *path, const unsigned char *fp);
+void manifest_set_cert(const char *path, const unsigned char *fp);
+void manifest_cleanup(void);
+
+#endif /* MANIFEST_H */
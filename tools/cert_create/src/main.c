@@ -7,10 +7,12 @@
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <unistd.h>
 
 #include <openssl/conf.h>
 #include <openssl/engine.h>
@@ -24,6 +26,7 @@
 #include "debug.h"
 #include "ext.h"
 #include "key.h"
+#include "manifest.h"
 #include "sha.h"
 
 /*
@@ -57,6 +60,7 @@
 #define ID_TO_BIT_MASK(id)		(1 << id)
 #define NUM_ELEM(x)			((sizeof(x)) / (sizeof(x[0])))
 #define HELP_OPT_MAX_LEN		128
+#define MAX_JOBS			64
 
 /* Global options */
 static int key_alg;
@@ -65,6 +69,15 @@ static int key_size;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static int num_jobs;
+static const char *manifest_fn;
+
+/* Image hash algorithm */
+static const EVP_MD *md_info;
+static unsigned int md_len;
+
+/* Digest of the image of each hash extension, computed before signing */
+static unsigned char (*ext_md)[SHA512_DIGEST_LENGTH];
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -261,6 +274,263 @@ static void check_cmd_params(void)
 	}
 }
 
+/*
+ * Work shared between the threads of run_jobs(). Items are handed out one at a
+ * time, so that a large image or a slow key does not hold up the others.
+ */
+typedef struct job_queue_s {
+	void (*fn)(int);
+	const int *items;
+	int num_items;
+	int next;
+	pthread_mutex_t lock;
+} job_queue_t;
+
+static void *job_thread(void *arg)
+{
+	job_queue_t *queue = arg;
+	int i;
+
+	for (;;) {
+		pthread_mutex_lock(&queue->lock);
+		i = queue->next++;
+		pthread_mutex_unlock(&queue->lock);
+
+		if (i >= queue->num_items) {
+			break;
+		}
+		queue->fn(queue->items[i]);
+	}
+
+	return NULL;
+}
+
+/*
+ * Call 'fn' on each of the items, on up to 'num_jobs' threads. The calling
+ * thread is one of them, so this degrades to a plain loop if no thread can be
+ * created.
+ */
+static void run_jobs(void (*fn)(int), const int *items, int num_items)
+{
+	pthread_t threads[MAX_JOBS];
+	job_queue_t queue;
+	int i, num_threads;
+
+	if (num_items == 0) {
+		return;
+	}
+
+	queue.fn = fn;
+	queue.items = items;
+	queue.num_items = num_items;
+	queue.next = 0;
+	pthread_mutex_init(&queue.lock, NULL);
+
+	num_threads = (num_jobs < num_items) ? num_jobs : num_items;
+	for (i = 1; i < num_threads; i++) {
+		if (pthread_create(&threads[i], NULL, job_thread, &queue) != 0) {
+			break;
+		}
+	}
+	num_threads = i;
+
+	job_thread(&queue);
+
+	for (i = 1; i < num_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	pthread_mutex_destroy(&queue.lock);
+}
+
+static void create_key_job(int i)
+{
+	NOTICE("Creating new key for '%s'\n", keys[i].desc);
+	if (!key_create(&keys[i], key_alg, key_size)) {
+		ERROR("Error creating key '%s'\n", keys[i].desc);
+		exit(1);
+	}
+}
+
+static void hash_image_job(int i)
+{
+	if (!sha_file(hash_alg, extensions[i].arg, ext_md[i])) {
+		ERROR("Cannot calculate hash of %s\n", extensions[i].arg);
+		exit(1);
+	}
+}
+
+static void create_cert_job(int i)
+{
+	STACK_OF(X509_EXTENSION) * sk;
+	X509_EXTENSION *cert_ext = NULL;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+	cert_t *cert = &certs[i];
+	ext_t *ext;
+	int j, ext_nid, nvctr;
+
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+
+		ext = &extensions[cert->ext[j]];
+
+		/* Get OpenSSL internal ID for this extension */
+		CHECK_OID(ext_nid, ext->oid);
+
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->optional && ext->arg == NULL) {
+				/* Skip this NVCounter */
+				continue;
+			} else {
+				/* Checked by `check_cmd_params` */
+				assert(ext->arg != NULL);
+				nvctr = atoi(ext->arg);
+				CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, nvctr));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			if (ext->arg == NULL) {
+				if (ext->optional) {
+					/* Include a hash filled with zeros */
+					memset(md, 0x0, SHA512_DIGEST_LENGTH);
+				} else {
+					/* Do not include this hash in the certificate */
+					continue;
+				}
+			} else {
+				/* Hashed beforehand by hash_image_job() */
+				memcpy(md, ext_md[cert->ext[j]], md_len);
+			}
+			CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+					EXT_CRIT, md_info, md,
+					md_len));
+			break;
+		case EXT_TYPE_PKEY:
+			CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->attr.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type '%d' in %s\n",
+					ext->type, cert->cn);
+			exit(1);
+		}
+
+		/* Push the extension into the stack */
+		sk_X509_EXTENSION_push(sk, cert_ext);
+	}
+
+	/* Create certificate. Signed with corresponding key */
+	if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
+		ERROR("Cannot create %s\n", cert->cn);
+		exit(1);
+	}
+
+	for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
+			cert_ext = sk_X509_EXTENSION_pop(sk)) {
+		X509_EXTENSION_free(cert_ext);
+	}
+
+	sk_X509_EXTENSION_free(sk);
+}
+
+static void fp_update_key(EVP_MD_CTX *ctx, EVP_PKEY *pkey)
+{
+	unsigned char *der = NULL;
+	int len;
+
+	if (pkey == NULL) {
+		EVP_DigestUpdate(ctx, "none", 4);
+		return;
+	}
+
+	len = i2d_PUBKEY(pkey, &der);
+	if (len <= 0) {
+		ERROR("Cannot encode public key\n");
+		exit(1);
+	}
+	EVP_DigestUpdate(ctx, der, len);
+	OPENSSL_free(der);
+}
+
+/*
+ * Compute the fingerprint of everything a certificate is generated from: the
+ * tool itself, the algorithms, the content of its extensions, its keys and,
+ * through its fingerprint, the issuer certificate.
+ */
+static void cert_fingerprint(int i, unsigned char (*fp)[MANIFEST_FP_LEN],
+		bool *fp_done)
+{
+	cert_t *cert = &certs[i];
+	cert_t *issuer_cert = &certs[cert->issuer];
+	unsigned char zeros[SHA512_DIGEST_LENGTH] = { 0 };
+	EVP_MD_CTX *ctx;
+	ext_t *ext;
+	int j, val[2];
+
+	if (fp_done[i]) {
+		return;
+	}
+
+	CHECK_NULL(ctx, EVP_MD_CTX_create());
+	if (!EVP_DigestInit_ex(ctx, EVP_sha256(), NULL)) {
+		ERROR("Cannot initialize certificate fingerprint\n");
+		exit(1);
+	}
+
+	EVP_DigestUpdate(ctx, build_msg, strlen(build_msg) + 1);
+	EVP_DigestUpdate(ctx, cert->cn, strlen(cert->cn) + 1);
+	EVP_DigestUpdate(ctx, issuer_cert->cn, strlen(issuer_cert->cn) + 1);
+	EVP_DigestUpdate(ctx, &hash_alg, sizeof(hash_alg));
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+		ext = &extensions[cert->ext[j]];
+		val[0] = cert->ext[j];
+		val[1] = (ext->arg != NULL);
+		EVP_DigestUpdate(ctx, val, sizeof(val));
+
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->arg != NULL) {
+				val[0] = atoi(ext->arg);
+				EVP_DigestUpdate(ctx, &val[0], sizeof(val[0]));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			EVP_DigestUpdate(ctx, (ext->arg != NULL) ?
+				ext_md[cert->ext[j]] : zeros, md_len);
+			break;
+		case EXT_TYPE_PKEY:
+			fp_update_key(ctx, keys[ext->attr.key].key);
+			break;
+		default:
+			break;
+		}
+	}
+
+	fp_update_key(ctx, keys[cert->key].key);
+	fp_update_key(ctx, keys[issuer_cert->key].key);
+
+	/* The issuer certificate is only used if it is being generated too */
+	if (cert->issuer != i && issuer_cert->fn != NULL) {
+		cert_fingerprint(cert->issuer, fp, fp_done);
+		EVP_DigestUpdate(ctx, fp[cert->issuer], MANIFEST_FP_LEN);
+	}
+
+	EVP_DigestFinal_ex(ctx, fp[i], NULL);
+	EVP_MD_CTX_destroy(ctx);
+	fp_done[i] = true;
+}
+
 /* Common command line options */
 static const cmd_opt_t common_cmd_opt[] = {
 	{
@@ -291,25 +561,34 @@ static const cmd_opt_t common_cmd_opt[] = {
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of threads creating keys, hashing images and signing " \
+		"certificates (default: number of online CPUs)"
+	},
+	{
+		{ "manifest", required_argument, NULL, 'm' },
+		"Only sign again the certificates whose inputs changed since " \
+		"the given manifest was written, and update it"
 	}
 };
 
 int main(int argc, char *argv[])
 {
-	STACK_OF(X509_EXTENSION) * sk;
-	X509_EXTENSION *cert_ext = NULL;
 	ext_t *ext;
 	key_t *key;
 	cert_t *cert;
 	FILE *file;
-	int i, j, ext_nid, nvctr;
+	int i, j;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
 	const char *cur_opt;
 	unsigned int err_code;
-	unsigned char md[SHA512_DIGEST_LENGTH];
-	unsigned int  md_len;
-	const EVP_MD *md_info;
+	int *items, num_items, idx;
+	bool *ext_hashed, *cert_kept, *fp_done;
+	unsigned char (*cert_fp)[MANIFEST_FP_LEN];
+	long num_cpus;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -347,7 +626,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:b:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:b:hj:km:nps:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -372,9 +651,19 @@ int main(int argc, char *argv[])
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			exit(0);
+		case 'j':
+			num_jobs = atoi(optarg);
+			if (num_jobs <= 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
+		case 'm':
+			manifest_fn = strdup(optarg);
+			break;
 		case 'n':
 			new_keys = 1;
 			break;
@@ -431,7 +720,35 @@ int main(int argc, char *argv[])
 		md_len  = SHA256_DIGEST_LENGTH;
 	}
 
-	/* Load private keys from files (or generate new ones) */
+	/* Use one thread per online CPU unless told otherwise */
+	if (num_jobs == 0) {
+		num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		num_jobs = (num_cpus > 0) ? num_cpus : 1;
+	}
+	if (num_jobs > MAX_JOBS) {
+		num_jobs = MAX_JOBS;
+	}
+
+	items = malloc(sizeof(*items) *
+		(num_keys > num_extensions ? num_keys : num_extensions) +
+		sizeof(*items) * num_certs);
+	ext_md = calloc(num_extensions, sizeof(*ext_md));
+	ext_hashed = calloc(num_extensions, sizeof(*ext_hashed));
+	cert_fp = calloc(num_certs, sizeof(*cert_fp));
+	cert_kept = calloc(num_certs, sizeof(*cert_kept));
+	fp_done = calloc(num_certs, sizeof(*fp_done));
+	if (items == NULL || ext_md == NULL ||
+			ext_hashed == NULL || cert_fp == NULL ||
+			cert_kept == NULL || fp_done == NULL) {
+		ERROR("Cannot allocate memory\n");
+		exit(1);
+	}
+
+	/*
+	 * Load private keys from files. The keys that need to be generated are
+	 * created in parallel afterwards.
+	 */
+	num_items = 0;
 	for (i = 0 ; i < num_keys ; i++) {
 #if !USING_OPENSSL3
 		if (!key_new(&keys[i])) {
@@ -457,12 +774,8 @@ int main(int argc, char *argv[])
 		/* File does not exist, could not be opened or no filename was
 		 * given */
 		if (new_keys) {
-			/* Try to create a new key */
-			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg, key_size)) {
-				ERROR("Error creating key '%s'\n", keys[i].desc);
-				exit(1);
-			}
+			/* Create a new key */
+			items[num_items++] = i;
 		} else {
 			if (err_code == KEY_ERR_OPEN) {
 				ERROR("Error opening '%s'\n", keys[i].fn);
@@ -472,96 +785,87 @@ int main(int argc, char *argv[])
 			exit(1);
 		}
 	}
+	run_jobs(create_key_job, items, num_items);
 
-	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
+	if (manifest_fn != NULL) {
+		manifest_load(manifest_fn);
+	}
 
+	/*
+	 * Hash the images of the requested certificates. They are always
+	 * hashed, the manifest only lets certificates be kept unsigned again.
+	 */
+	num_items = 0;
+	for (i = 0 ; i < num_certs ; i++) {
 		cert = &certs[i];
-
 		if (cert->fn == NULL) {
-			/* Certificate not requested. Skip to the next one */
 			continue;
 		}
 
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
-
 		for (j = 0 ; j < cert->num_ext ; j++) {
+			idx = cert->ext[j];
+			ext = &extensions[idx];
+			if (ext->type != EXT_TYPE_HASH || ext->arg == NULL ||
+					ext_hashed[idx]) {
+				continue;
+			}
+			ext_hashed[idx] = true;
+			items[num_items++] = idx;
+		}
+	}
+	run_jobs(hash_image_job, items, num_items);
 
-			ext = &extensions[cert->ext[j]];
-
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
+	if (manifest_fn != NULL) {
+		/*
+		 * Keep the certificates generated from the same image digests,
+		 * keys and other inputs.
+		 */
+		for (i = 0 ; i < num_certs ; i++) {
+			cert = &certs[i];
+			if (cert->fn == NULL) {
+				continue;
+			}
 
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->optional && ext->arg == NULL) {
-					/* Skip this NVCounter */
-					continue;
-				} else {
-					/* Checked by `check_cmd_params` */
-					assert(ext->arg != NULL);
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
-				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA512_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						continue;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
-				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						md_len));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
+			cert_fingerprint(i, cert_fp, fp_done);
+			if (!manifest_cert_unchanged(cert->fn, cert_fp[i])) {
+				continue;
 			}
 
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
+			file = fopen(cert->fn, "rb");
+			if (file != NULL) {
+				cert->x = d2i_X509_fp(file, NULL);
+				fclose(file);
+			}
+			if (cert->x != NULL) {
+				NOTICE("Keeping %s, inputs unchanged\n", cert->fn);
+				cert_kept[i] = true;
+			}
 		}
+	}
 
-		/* Create certificate. Signed with corresponding key */
-		if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
-			exit(1);
-		}
+	/*
+	 * Create the certificates. Each one is signed once its issuer
+	 * certificate exists, all the certificates whose issuer is ready being
+	 * signed in parallel.
+	 */
+	do {
+		num_items = 0;
+		for (i = 0 ; i < num_certs ; i++) {
+			cert = &certs[i];
+			if (cert->fn == NULL || cert->x != NULL) {
+				/* Not requested, or already created */
+				continue;
+			}
 
-		for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
-				cert_ext = sk_X509_EXTENSION_pop(sk)) {
-			X509_EXTENSION_free(cert_ext);
+			if (cert->issuer != i && certs[cert->issuer].fn != NULL &&
+					certs[cert->issuer].x == NULL) {
+				/* Wait for the issuer certificate */
+				continue;
+			}
+			items[num_items++] = i;
 		}
-
-		sk_X509_EXTENSION_free(sk);
-	}
-
+		run_jobs(create_cert_job, items, num_items);
+	} while (num_items != 0);
 
 	/* Print the certificates */
 	if (print_cert) {
@@ -576,17 +880,28 @@ int main(int argc, char *argv[])
 
 	/* Save created certificates to files */
 	for (i = 0 ; i < num_certs ; i++) {
-		if (certs[i].x && certs[i].fn) {
+		if (certs[i].x && certs[i].fn && !cert_kept[i]) {
 			file = fopen(certs[i].fn, "w");
 			if (file != NULL) {
 				i2d_X509_fp(file, certs[i].x);
 				fclose(file);
+				if (manifest_fn != NULL) {
+					manifest_set_cert(certs[i].fn,
+						cert_fp[i]);
+				}
 			} else {
 				ERROR("Cannot create file %s\n", certs[i].fn);
 			}
 		}
 	}
 
+	if (manifest_fn != NULL) {
+		if (!manifest_save(manifest_fn)) {
+			ERROR("Cannot save %s\n", manifest_fn);
+		}
+		manifest_cleanup();
+	}
+
 	/* Save keys */
 	if (save_keys) {
 		for (i = 0 ; i < num_keys ; i++) {
@@ -613,5 +928,12 @@ int main(int argc, char *argv[])
 
 	cert_cleanup();
 
+	free(items);
+	free(ext_md);
+	free(ext_hashed);
+	free(cert_fp);
+	free(cert_kept);
+	free(fp_done);
+
 	return 0;
 }
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2022, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "debug.h"
+#include "manifest.h"
+
+#define MAX_LINE_LEN			2048
+
+/* One line of the manifest */
+typedef struct manifest_entry_s manifest_entry_t;
+struct manifest_entry_s {
+	unsigned char fp[MANIFEST_FP_LEN];
+	char *path;
+	manifest_entry_t *next;
+};
+
+static manifest_entry_t *entries;
+
+static manifest_entry_t *lookup(const char *path)
+{
+	manifest_entry_t *entry;
+
+	for (entry = entries; entry != NULL; entry = entry->next) {
+		if (strcmp(entry->path, path) == 0) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static manifest_entry_t *lookup_or_add(const char *path)
+{
+	manifest_entry_t *entry;
+	size_t len;
+
+	entry = lookup(path);
+	if (entry != NULL) {
+		return entry;
+	}
+
+	len = strlen(path) + 1;
+	entry = calloc(1, sizeof(*entry));
+	if (entry != NULL) {
+		entry->path = malloc(len);
+	}
+	if (entry == NULL || entry->path == NULL) {
+		ERROR("%s(): Cannot allocate manifest entry\n", __func__);
+		exit(1);
+	}
+	memcpy(entry->path, path, len);
+	entry->next = entries;
+	entries = entry;
+
+	return entry;
+}
+
+static int hex_to_bin(const char *hex, unsigned char *buf, unsigned int *len)
+{
+	unsigned int i, n = strlen(hex) / 2;
+	unsigned int byte;
+
+	if (n == 0 || n > MANIFEST_FP_LEN || strlen(hex) != 2 * n) {
+		return 0;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (sscanf(&hex[2 * i], "%2x", &byte) != 1) {
+			return 0;
+		}
+		buf[i] = byte;
+	}
+	*len = n;
+
+	return 1;
+}
+
+static void print_hex(FILE *file, const unsigned char *buf, unsigned int len)
+{
+	unsigned int i;
+
+	for (i = 0; i < len; i++) {
+		fprintf(file, "%02x", buf[i]);
+	}
+}
+
+/*
+ * Load the manifest left by a previous run. A missing manifest is not an
+ * error, everything is then generated again.
+ */
+int manifest_load(const char *fn)
+{
+	char line[MAX_LINE_LEN];
+	char hex[2 * MANIFEST_FP_LEN + 1];
+	manifest_entry_t *entry;
+	unsigned char fp[MANIFEST_FP_LEN];
+	unsigned int fp_len;
+	FILE *file;
+	int n;
+
+	file = fopen(fn, "r");
+	if (file == NULL) {
+		return 1;
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		line[strcspn(line, "\n")] = '\0';
+
+		n = 0;
+		if (sscanf(line, "cert %64s %n", hex, &n) != 1 || n <= 0 ||
+				line[n] == '\0' || !hex_to_bin(hex, fp, &fp_len) ||
+				fp_len != MANIFEST_FP_LEN) {
+			WARN("Ignoring invalid line in %s: %s\n", fn, line);
+			continue;
+		}
+		entry = lookup_or_add(&line[n]);
+		memcpy(entry->fp, fp, MANIFEST_FP_LEN);
+	}
+
+	fclose(file);
+
+	return 1;
+}
+
+int manifest_save(const char *fn)
+{
+	manifest_entry_t *entry;
+	FILE *file;
+
+	file = fopen(fn, "w");
+	if (file == NULL) {
+		return 0;
+	}
+
+	for (entry = entries; entry != NULL; entry = entry->next) {
+		fprintf(file, "cert ");
+		print_hex(file, entry->fp, MANIFEST_FP_LEN);
+		fprintf(file, " %s\n", entry->path);
+	}
+
+	return fclose(file) == 0;
+}
+
+/*
+ * A certificate is only kept if it still exists and was generated from the
+ * same inputs.
+ */
+int manifest_cert_unchanged(const char *path, const unsigned char *fp)
+{
+	manifest_entry_t *entry = lookup(path);
+	struct stat st;
+
+	if (entry == NULL || memcmp(entry->fp, fp, MANIFEST_FP_LEN) != 0) {
+		return 0;
+	}
+
+	return stat(path, &st) == 0;
+}
+
+void manifest_set_cert(const char *path, const unsigned char *fp)
+{
+	manifest_entry_t *entry = lookup_or_add(path);
+
+	memcpy(entry->fp, fp, MANIFEST_FP_LEN);
+}
+
+void manifest_cleanup(void)
+{
+	manifest_entry_t *entry;
+
+	while (entries != NULL) {
+		entry = entries;
+		entries = entry->next;
+		free(entry->path);
+		free(entry);
+	}
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -22,6 +22,10 @@
 #define OPT_TOC_ENTRY 0
 #define OPT_PLAT_TOC_FLAGS 1
 #define OPT_ALIGN 2
+#define OPT_IN_PLACE 3
+
+/* Upper bound on the number of threads hashing images in parallel. */
+#define HASH_MAX_THREADS 32
 
 static int info_cmd(int argc, char *argv[]);
 static void info_usage(int);
@@ -53,6 +57,8 @@ static image_desc_t *image_desc_head;
 static size_t nr_image_descs;
 static const uuid_t uuid_null;
 static int verbose;
+/* The FIP parsed by parse_fip(), which its images point into. */
+static mapping_t *fip_map;
 
 static void vlog(int prio, const char *msg, va_list ap)
 {
@@ -134,6 +140,89 @@ static void xfwrite(void *buf, size_t size, FILE *fp, const char *filename)
 		log_errx("Failed to write %s", filename);
 }
 
+static void xfwrite_zeros(uint64_t size, FILE *fp, const char *filename)
+{
+	static char zeros[4096];
+
+	while (size > 0) {
+		size_t len = size < sizeof(zeros) ? size : sizeof(zeros);
+
+		xfwrite(zeros, len, fp, filename);
+		size -= len;
+	}
+}
+
+/*
+ * Load a whole file in memory. On POSIX hosts the file is mapped read-only
+ * instead of being read, so images are never copied in user space and only
+ * the pages that are actually used get read from disk.
+ */
+static mapping_t *map_file(const char *filename)
+{
+	mapping_t *map;
+	FILE *fp;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	map = xzalloc(sizeof(*map), "failed to allocate memory for mapping");
+	if (fstat(fileno(fp), &map->st) == -1)
+		log_err("fstat %s", filename);
+	map->size = map->st.st_size;
+	map->refs = 1;
+
+	if (map->size != 0) {
+#ifndef _MSC_VER
+		map->base = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE,
+		    fileno(fp), 0);
+		if (map->base == MAP_FAILED)
+			log_err("mmap %s", filename);
+#else
+		map->base = xmalloc(map->size,
+		    "failed to load file into memory");
+		if (fread(map->base, 1, map->size, fp) != map->size)
+			log_errx("Failed to read %s", filename);
+#endif
+	}
+
+	fclose(fp);
+	return map;
+}
+
+static void put_mapping(mapping_t *map)
+{
+	assert(map->refs > 0);
+
+	if (--map->refs != 0)
+		return;
+	if (map->size != 0) {
+#ifndef _MSC_VER
+		munmap(map->base, map->size);
+#else
+		free(map->base);
+#endif
+	}
+	free(map);
+}
+
+static void free_image(image_t *image)
+{
+	if (image->map != NULL)
+		put_mapping(image->map);
+	else
+		free(image->buffer);
+	free(image);
+}
+
+static int same_image_data(const image_t *a, const image_t *b)
+{
+	return a->toc_e.size == b->toc_e.size &&
+	    a->toc_e.flags == b->toc_e.flags &&
+	    (a->toc_e.size == 0ULL ||
+	     memcmp(a->buffer, b->buffer, a->toc_e.size) == 0);
+}
+
 static image_desc_t *new_image_desc(const uuid_t *uuid,
     const char *name, const char *cmdline_name)
 {
@@ -169,10 +258,8 @@ static void free_image_desc(image_desc_t *desc)
 	free(desc->name);
 	free(desc->cmdline_name);
 	free(desc->action_arg);
-	if (desc->image) {
-		free(desc->image->buffer);
-		free(desc->image);
-	}
+	if (desc->image)
+		free_image(desc->image);
 	free(desc);
 }
 
@@ -292,27 +379,23 @@ static void uuid_from_str(uuid_t *u, const char *s)
 
 static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 {
-	struct BLD_PLAT_STAT st;
-	FILE *fp;
+	mapping_t *map;
 	char *buf, *bufend;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	int terminated = 0;
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_err("fstat %s", filename);
+	assert(fip_map == NULL);
 
-	buf = xmalloc(st.st_size, "failed to load file into memory");
-	if (fread(buf, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	bufend = buf + st.st_size;
-	fclose(fp);
+	/*
+	 * The images are not copied out of the FIP, they keep referencing it
+	 * until they are replaced or written out.
+	 */
+	map = map_file(filename);
+	buf = map->base;
+	bufend = buf + map->size;
 
-	if (st.st_size < sizeof(fip_toc_header_t))
+	if (map->size < sizeof(fip_toc_header_t))
 		log_errx("FIP %s is truncated", filename);
 
 	toc_header = (fip_toc_header_t *)buf;
@@ -343,16 +426,15 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 		image = xzalloc(sizeof(*image),
 		    "failed to allocate memory for image");
 		image->toc_e = *toc_entry;
-		image->buffer = xmalloc(toc_entry->size,
-		    "failed to allocate image buffer, is FIP file corrupted?");
-		/* Overflow checks before memory copy. */
+		/* Overflow checks before referencing the image data. */
 		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
 			log_errx("FIP %s is corrupted", filename);
-		if (toc_entry->size + toc_entry->offset_address > st.st_size)
+		if (toc_entry->size + toc_entry->offset_address > map->size)
 			log_errx("FIP %s is corrupted", filename);
 
-		memcpy(image->buffer, buf + toc_entry->offset_address,
-		    toc_entry->size);
+		image->buffer = buf + toc_entry->offset_address;
+		image->map = map;
+		map->refs++;
 
 		/* If this is an unknown image, create a descriptor for it. */
 		desc = lookup_image_desc_from_uuid(&toc_entry->uuid);
@@ -378,37 +460,61 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
+	fip_map = map;
 	return 0;
 }
 
 static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
 {
-	struct BLD_PLAT_STAT st;
 	image_t *image;
-	FILE *fp;
 
 	assert(uuid != NULL);
 	assert(filename != NULL);
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_errx("fstat %s", filename);
-
 	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
 	image->toc_e.uuid = *uuid;
-	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	image->toc_e.size = st.st_size;
-
-	fclose(fp);
+	image->map = map_file(filename);
+	image->buffer = image->map->base;
+	image->toc_e.size = image->map->size;
 	return image;
 }
 
+/*
+ * Images reference the files they were loaded from. Copy the ones backed by
+ * the given file before it is overwritten, as truncating a mapped file would
+ * pull the data from under them.
+ */
+static void detach_images(const char *filename)
+{
+#ifndef _MSC_VER
+	struct BLD_PLAT_STAT st;
+	image_desc_t *desc;
+
+	if (stat(filename, &st) == -1)
+		return;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+		void *buf;
+
+		if (image == NULL || image->map == NULL ||
+		    image->map->st.st_dev != st.st_dev ||
+		    image->map->st.st_ino != st.st_ino)
+			continue;
+
+		buf = xmalloc(image->toc_e.size,
+		    "failed to allocate image buffer");
+		memcpy(buf, image->buffer, image->toc_e.size);
+		put_mapping(image->map);
+		image->map = NULL;
+		image->buffer = buf;
+	}
+#else
+	/* Files are read in memory rather than mapped, nothing to do. */
+	(void)filename;
+#endif
+}
+
 static int write_image_to_file(const image_t *image, const char *filename)
 {
 	FILE *fp;
@@ -454,10 +560,97 @@ static void md_print(const unsigned char *md, size_t len)
 		printf("%02x", md[i]);
 }
 
+#ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
+typedef struct hash_job {
+	image_t       **images;
+	unsigned char (*md)[SHA256_DIGEST_LENGTH];
+	size_t          nr_images;
+	size_t          first;
+	size_t          stride;
+} hash_job_t;
+
+static void *hash_images_thread(void *arg)
+{
+	hash_job_t *job = arg;
+	size_t i;
+
+	for (i = job->first; i < job->nr_images; i += job->stride)
+		SHA256(job->images[i]->buffer, job->images[i]->toc_e.size,
+		    job->md[i]);
+	return NULL;
+}
+
+/*
+ * Compute the SHA256 digest of each image in the table, in table order. The
+ * images are shared out between up to one thread per online CPU, the calling
+ * thread taking the first share.
+ */
+static unsigned char (*hash_images(void))[SHA256_DIGEST_LENGTH]
+{
+	pthread_t threads[HASH_MAX_THREADS];
+	int started[HASH_MAX_THREADS] = { 0 };
+	hash_job_t jobs[HASH_MAX_THREADS];
+	unsigned char (*md)[SHA256_DIGEST_LENGTH];
+	image_t **images;
+	image_desc_t *desc;
+	size_t i, nr_images = 0, nr_threads;
+	long nr_cpus;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (desc->image != NULL)
+			nr_images++;
+	if (nr_images == 0)
+		return NULL;
+
+	images = xmalloc(nr_images * sizeof(*images),
+	    "failed to allocate memory for image list");
+	md = xmalloc(nr_images * sizeof(*md),
+	    "failed to allocate memory for digests");
+	for (i = 0, desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (desc->image != NULL)
+			images[i++] = desc->image;
+
+	nr_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	nr_threads = nr_cpus > 0 ? (size_t)nr_cpus : 1;
+	if (nr_threads > HASH_MAX_THREADS)
+		nr_threads = HASH_MAX_THREADS;
+	if (nr_threads > nr_images)
+		nr_threads = nr_images;
+
+	for (i = 0; i < nr_threads; i++) {
+		jobs[i].images = images;
+		jobs[i].md = md;
+		jobs[i].nr_images = nr_images;
+		jobs[i].first = i;
+		jobs[i].stride = nr_threads;
+	}
+
+	for (i = 1; i < nr_threads; i++)
+		started[i] = pthread_create(&threads[i], NULL,
+		    hash_images_thread, &jobs[i]) == 0;
+
+	/* Hash the share of any thread that could not be created here. */
+	for (i = 0; i < nr_threads; i++)
+		if (!started[i])
+			hash_images_thread(&jobs[i]);
+
+	for (i = 1; i < nr_threads; i++)
+		if (started[i] && pthread_join(threads[i], NULL) != 0)
+			log_errx("Failed to join hashing thread");
+
+	free(images);
+	return md;
+}
+#endif
+
 static int info_cmd(int argc, char *argv[])
 {
 	image_desc_t *desc;
 	fip_toc_header_t toc_header;
+#ifndef _MSC_VER
+	unsigned char (*md)[SHA256_DIGEST_LENGTH] = NULL;
+	size_t i = 0;
+#endif
 
 	if (argc != 2)
 		info_usage(EXIT_FAILURE);
@@ -472,6 +665,9 @@ static int info_cmd(int argc, char *argv[])
 		    (unsigned long long)toc_header.serial_number);
 		log_dbgx("toc_header[flags]: 0x%llX",
 		    (unsigned long long)toc_header.flags);
+#ifndef _MSC_VER
+		md = hash_images();
+#endif
 	}
 
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
@@ -486,16 +682,16 @@ static int info_cmd(int argc, char *argv[])
 		       desc->cmdline_name);
 #ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
 		if (verbose) {
-			unsigned char md[SHA256_DIGEST_LENGTH];
-
-			SHA256(image->buffer, image->toc_e.size, md);
 			printf(", sha256=");
-			md_print(md, sizeof(md));
+			md_print(md[i++], SHA256_DIGEST_LENGTH);
 		}
 #endif
 		putchar('\n');
 	}
 
+#ifndef _MSC_VER
+	free(md);
+#endif
 	return 0;
 }
 
@@ -555,6 +751,7 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	toc_entry->offset_address = (entry_offset + align - 1) & ~(align - 1);
 
 	/* Generate the FIP file. */
+	detach_images(filename);
 	fp = fopen(filename, "wb");
 	if (fp == NULL)
 		log_err("fopen %s", filename);
@@ -582,8 +779,7 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 		log_errx("Failed to set file position");
 
 	pad_size = toc_entry->offset_address - entry_offset;
-	while (pad_size--)
-		fputc(0x0, fp);
+	xfwrite_zeros(pad_size, fp, filename);
 
 	free(buf);
 	fclose(fp);
@@ -611,12 +807,23 @@ static void update_fip(void)
 		image = read_image_from_file(&desc->uuid,
 		    desc->action_arg);
 		if (desc->image != NULL) {
+			/* Keep the packed image if it is not changing. */
+			if (same_image_data(image, desc->image)) {
+				if (verbose)
+					log_dbgx("%s is unchanged",
+					    desc->cmdline_name);
+				free_image(image);
+				continue;
+			}
 			if (verbose) {
 				log_dbgx("Replacing %s with %s",
 				    desc->cmdline_name,
 				    desc->action_arg);
 			}
-			free(desc->image);
+			/* Record where it was, for update_fip_in_place(). */
+			image->toc_e.offset_address =
+			    desc->image->toc_e.offset_address;
+			free_image(desc->image);
 			desc->image = image;
 		} else {
 			if (verbose)
@@ -627,6 +834,107 @@ static void update_fip(void)
 	}
 }
 
+/*
+ * Return the ToC entry of the given image in the parsed FIP, and the space
+ * available to it in the file, up to the next image or the end of the FIP.
+ */
+static const fip_toc_entry_t *lookup_fip_toc_entry(const uuid_t *uuid,
+    uint64_t *slot_size)
+{
+	const fip_toc_entry_t *toc_entry, *found = NULL;
+	uint64_t end = fip_map->size;
+
+	toc_entry = (const fip_toc_entry_t *)
+	    ((const fip_toc_header_t *)fip_map->base + 1);
+	for (; memcmp(&toc_entry->uuid, &uuid_null, sizeof(uuid_t)) != 0;
+	    toc_entry++)
+		if (memcmp(&toc_entry->uuid, uuid, sizeof(uuid_t)) == 0)
+			found = toc_entry;
+	if (found == NULL)
+		return NULL;
+
+	toc_entry = (const fip_toc_entry_t *)
+	    ((const fip_toc_header_t *)fip_map->base + 1);
+	for (; memcmp(&toc_entry->uuid, &uuid_null, sizeof(uuid_t)) != 0;
+	    toc_entry++)
+		if (toc_entry->offset_address > found->offset_address &&
+		    toc_entry->offset_address < end)
+			end = toc_entry->offset_address;
+
+	*slot_size = end - found->offset_address;
+	return found;
+}
+
+/*
+ * Write the images replaced by update_fip() over the ones they replace in the
+ * parsed FIP, leaving everything else in the file untouched. This is only
+ * possible when no image is added and each new image fits, suitably aligned,
+ * in the space of the image it replaces. Returns 0 if the FIP needs to be
+ * packed again instead.
+ */
+static int update_fip_in_place(const char *filename, uint64_t toc_flags,
+    unsigned long align)
+{
+	const fip_toc_header_t *toc_header;
+	const fip_toc_entry_t *toc_entry;
+	image_desc_t *desc;
+	uint64_t slot_size;
+	FILE *fp;
+
+	if (fip_map == NULL)
+		return 0;
+
+	/* Check that all the new images fit before writing anything. */
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL || image->map == fip_map)
+			continue;
+		toc_entry = lookup_fip_toc_entry(&desc->uuid, &slot_size);
+		if (toc_entry == NULL || image->toc_e.size == 0ULL ||
+		    image->toc_e.size > slot_size ||
+		    (toc_entry->offset_address & (align - 1)) != 0ULL)
+			return 0;
+	}
+
+	fp = fopen(filename, "r+b");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	toc_header = fip_map->base;
+	if (toc_header->flags != toc_flags) {
+		fip_toc_header_t new_header = *toc_header;
+
+		new_header.flags = toc_flags;
+		xfwrite(&new_header, sizeof(new_header), fp, filename);
+	}
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL || image->map == fip_map)
+			continue;
+		if (verbose)
+			log_dbgx("Rewriting %s in place", desc->cmdline_name);
+
+		toc_entry = lookup_fip_toc_entry(&desc->uuid, &slot_size);
+		image->toc_e.offset_address = toc_entry->offset_address;
+		if (fseek(fp, (const char *)toc_entry -
+		    (const char *)fip_map->base, SEEK_SET))
+			log_errx("Failed to set file position");
+		xfwrite(&image->toc_e, sizeof(image->toc_e), fp, filename);
+
+		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
+			log_errx("Failed to set file position");
+		xfwrite(image->buffer, image->toc_e.size, fp, filename);
+		xfwrite_zeros(slot_size - image->toc_e.size, fp, filename);
+	}
+
+	if (fclose(fp) != 0)
+		log_err("fclose %s", filename);
+	return 1;
+}
+
 static void parse_plat_toc_flags(const char *arg, unsigned long long *toc_flags)
 {
 	unsigned long long flags;
@@ -783,6 +1091,7 @@ static int update_cmd(int argc, char *argv[])
 	unsigned long long toc_flags = 0;
 	unsigned long align = 1;
 	int pflag = 0;
+	int in_place = 0;
 
 	if (argc < 2)
 		update_usage(EXIT_FAILURE);
@@ -790,6 +1099,7 @@ static int update_cmd(int argc, char *argv[])
 	opts = fill_common_opts(opts, &nr_opts, required_argument);
 	opts = add_opt(opts, &nr_opts, "align", required_argument, OPT_ALIGN);
 	opts = add_opt(opts, &nr_opts, "blob", required_argument, 'b');
+	opts = add_opt(opts, &nr_opts, "in-place", no_argument, OPT_IN_PLACE);
 	opts = add_opt(opts, &nr_opts, "out", required_argument, 'o');
 	opts = add_opt(opts, &nr_opts, "plat-toc-flags", required_argument,
 	    OPT_PLAT_TOC_FLAGS);
@@ -839,6 +1149,9 @@ static int update_cmd(int argc, char *argv[])
 		case OPT_ALIGN:
 			align = get_image_align(optarg);
 			break;
+		case OPT_IN_PLACE:
+			in_place = 1;
+			break;
 		case 'o':
 			snprintf(outfile, sizeof(outfile), "%s", optarg);
 			break;
@@ -865,7 +1178,13 @@ static int update_cmd(int argc, char *argv[])
 
 	update_fip();
 
-	pack_images(outfile, toc_flags, align);
+	/*
+	 * On request, only rewrite the images that changed, if the layout
+	 * allows it. This may leave unused space in the FIP.
+	 */
+	if (!in_place || strcmp(outfile, argv[0]) != 0 ||
+	    !update_fip_in_place(outfile, toc_flags, align))
+		pack_images(outfile, toc_flags, align);
 	return 0;
 }
 
@@ -878,6 +1197,7 @@ static void update_usage(int exit_status)
 	printf("Options:\n");
 	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
 	printf("  --blob uuid=...,file=...\tAdd or update an image with the given UUID pointed to by file.\n");
+	printf("  --in-place\t\t\tOnly rewrite the changed images, if they fit in place.\n");
 	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
 	printf("\n");
@@ -1128,7 +1448,7 @@ static int remove_cmd(int argc, char *argv[])
 			if (verbose)
 				log_dbgx("Removing %s",
 				    desc->cmdline_name);
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = NULL;
 		} else {
 			log_warnx("%s does not exist in %s",
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -40,9 +40,18 @@ typedef struct image_desc {
 	struct image_desc *next;
 } image_desc_t;
 
+/* Input file loaded in memory, shared by all the images it contains. */
+typedef struct mapping {
+	void                *base;
+	size_t               size;
+	struct BLD_PLAT_STAT st;
+	int                  refs;
+} mapping_t;
+
 typedef struct image {
 	struct fip_toc_entry toc_e;
 	void                *buffer;
+	struct mapping      *map;	/* NULL if buffer is heap allocated */
 } image_t;
 
 typedef struct cmd {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -15,8 +15,11 @@
 #ifndef _MSC_VER
 
 /* Not Visual Studio, so include Posix Headers. */
+# include <sys/mman.h>
+# include <sys/stat.h>
 # include <getopt.h>
 # include <openssl/sha.h>
+# include <pthread.h>
 # include <unistd.h>
 
 # define  BLD_PLAT_STAT stat